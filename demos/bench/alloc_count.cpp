@@ -0,0 +1,27 @@
+// counts heap allocations of a benchmark, linked with the translated program by bench.sh
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static unsigned long long alloc_count = 0;
+
+void * operator new(std::size_t size) {
+	alloc_count++;
+	if (void * p = std::malloc(size == 0 ? 1 : size))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+void operator delete(void * p) noexcept {
+	std::free(p);
+}
+void operator delete(void * p, std::size_t) noexcept {
+	std::free(p);
+}
+
+struct AllocCountReport {
+	~AllocCountReport() {
+		fprintf(stderr, "allocations: %llu\n", alloc_count);
+	}
+} alloc_count_report;
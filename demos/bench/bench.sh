@@ -0,0 +1,28 @@
+#!/bin/bash
+
+find_for90std(){
+  for f in $*; do
+    sed -i.bak 's/\(\.\.\/for90std\/for90std\.h\)/..\/\1/g' $f && rm -f $f.bak
+  done
+}
+filter_cost_time(){
+  for f in $*; do
+      if grep -q "Cost time:" $f; then
+          sed -i.bak '1d' $f && rm -f $f.bak
+      else
+          echo "cost time not found in ${f}"
+      fi
+  done
+}
+cd ../../build && make -j 12 && cd ../demos/bench
+../../bin/CFortranTranslator -fF ./stencil.f90 > ./stencil.cpp
+filter_cost_time stencil.cpp
+find_for90std stencil.cpp
+
+g++  stencil.cpp -DPOSIX -O2 -fpermissive -std=c++17 -o stencil.out && time ./stencil.out && rm stencil.out
+
+../../bin/CFortranTranslator -fF ./calls.f90 > ./calls.cpp
+filter_cost_time calls.cpp
+find_for90std calls.cpp
+
+g++  calls.cpp alloc_count.cpp -DPOSIX -O2 -fpermissive -std=c++17 -o calls.out && time ./calls.out && rm calls.out
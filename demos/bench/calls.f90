@@ -0,0 +1,56 @@
+subroutine axpy(n, s, x, y)
+    implicit none
+    integer, intent(in) :: n
+    real, intent(in) :: s
+    real, intent(in) :: x(n)
+    real, intent(inout) :: y(n)
+    integer :: i
+    do i = 1, n
+        y(i) = y(i) + s * x(i)
+    end do
+end subroutine axpy
+
+subroutine relax(n, w, y)
+    implicit none
+    integer, intent(in) :: n
+    real, intent(in) :: w
+    real, intent(out) :: y(n)
+    integer :: i
+    do i = 1, n
+        y(i) = y(i) * w
+    end do
+end subroutine relax
+
+program calls
+    implicit none
+    integer, parameter :: n = 256
+    integer, parameter :: iters = 2000
+    real :: a(256, 256), x(256)
+    integer :: i, j, k
+    real :: s
+
+    do i = 1, n
+        x(i) = 1.0 / i
+    end do
+    do j = 1, n
+        do i = 1, n
+            a(i, j) = 0.0
+        end do
+    end do
+
+    ! one call per column, columns are passed as sections
+    do k = 1, iters
+        do j = 1, n
+            call axpy(n, 0.5, x, a(:, j))
+            call relax(n, 0.999, a(:, j))
+        end do
+    end do
+
+    s = 0.0
+    do j = 1, n
+        do i = 1, n
+            s = s + a(i, j)
+        end do
+    end do
+    print *, s
+end program calls
@@ -0,0 +1,44 @@
+program stencil
+    implicit none
+    integer, parameter :: n = 256
+    integer, parameter :: iters = 200
+    real :: a(256, 256), b(256, 256)
+    integer :: bounds(2)
+    integer :: i, j, k
+    real :: s
+
+    bounds(1) = 2
+    bounds(2) = n - 1
+    do j = 1, n
+        do i = 1, n
+            a(i, j) = 0.0
+            b(i, j) = 0.0
+        end do
+    end do
+    do i = 1, n
+        a(i, 1) = 1.0
+        b(i, 1) = 1.0
+    end do
+
+    ! 5-point jacobi sweep, loop bounds are read from an array element
+    do k = 1, iters
+        do j = bounds(1), bounds(2)
+            do i = bounds(1), bounds(2)
+                b(i, j) = 0.25 * (a(i - 1, j) + a(i + 1, j) + a(i, j - 1) + a(i, j + 1))
+            end do
+        end do
+        do j = bounds(1), bounds(2)
+            do i = bounds(1), bounds(2)
+                a(i, j) = b(i, j)
+            end do
+        end do
+    end do
+
+    s = 0.0
+    do j = 1, n
+        do i = 1, n
+            s = s + a(i, j)
+        end do
+    end do
+    print *, s
+end program stencil
@@ -1,7 +1,7 @@
 #include "common.h"
 
 TEST(farray, hiddendo){
-    farray<int> e = make_init_list({ 1,1 }, { 2,2 }, [](const fsize_t * current) {return ([](fsize_t i, fsize_t j) {return i + j; })(current[0], current[1]); });
+    farray<int> e = make_init_list({ 1,1 }, { 2,2 }, [](const fsize_t * current) {return ([](int i, int j) {return i + j; })(current[0], current[1]); });
     FILE * f = std::fopen(TF, "w");
     forwritefree(f, e); // 2 3 3 4
     forwrite(f, "%d %d\n", e); // 2 3\n 3 4
@@ -103,6 +103,7 @@ TEST(farray, slice){
     ASSERT_EQ(forslice(b, { { }, { 2,2 /* SLICE */} }), farray<int>({1, 1}, {1, 2}, {3, 4}));
     ASSERT_EQ(forslice(b, { { 1,1 },{  } }), farray<int>({1, 1}, {1, 2}, {1, 3}));
     ASSERT_EQ(forslice(b, { { 2 },{} }), farray<int>({1}, {2}, {2, 4}));
+    ASSERT_EQ(forslice(b, { { 2, 1, -1 },{ 2 } }), farray<int>({1}, {2}, {4, 3}));
     farray<int> aa = forconcat({ make_init_list({1,2,3}) });
     farray<int> c{ { 1 },{ 3 } };
     c = forslice(aa, { {} });
@@ -139,6 +140,115 @@ TEST(farray, order){
     ASSERT_EQ(a(1,4), 7);
 }
 
+TEST(farray, flatsize){
+    fsize_t delta[3];
+#ifndef FORARRAY_INDEX32
+    fsize_t sz[] = { 65536, 65536, 4 };
+    ASSERT_EQ(fa_getflatsize(sz, sz + 2), (fsize_t)65536 * 65536);
+    fa_layer_delta(sz, sz + 3, delta);
+    ASSERT_EQ(delta[2], (fsize_t)65536 * 65536);
+#endif
+    fsize_t huge[] = { std::numeric_limits<fsize_t>::max() / 2, 3 };
+    ASSERT_THROW(fa_getflatsize(huge, huge + 2), std::length_error);
+    ASSERT_THROW(fa_layer_delta(huge, huge + 2, delta), std::length_error);
+}
+
+TEST(farray, section){
+    farray<int> b{ { 1, 1 },{ 2, 3 },{ 1,2,3,4,5,6 } };
+    auto twice = [](farray<int> & x) {
+        x *= 2;
+    };
+    auto first = [](const farray<int> & x) {
+        return x.LBound(0) == 1 ? x(1) : -1;
+    };
+    // a column is contiguous, so it is a view
+    ASSERT_EQ(first(forsection(b, { { }, { 2 } })), 3);
+    ASSERT_EQ(forsection(b, { { }, { 2 } }).operator farray<int> &().begin(), &b(1, 2));
+    twice(forsection(b, { { }, { 2 } }));
+    // a row is copied in and copied out
+    twice(forsection(b, { { 1 }, { } }));
+    twice(forsection(b, { { 2 }, { 1, 3, 2 } }));
+    ASSERT_EQ(b, farray<int>({ 1, 1 }, { 2, 3 }, { 2, 4, 12, 8, 10, 12 }));
+}
+
+TEST(farray, strided){
+    farray<int> b{ { 1, 1 },{ 2, 3 },{ 1,2,3,4,5,6 } };
+    // sections are reduced in place
+    ASSERT_EQ(forsum(b, { { 2 }, { } }), 12);
+    ASSERT_EQ(forsum(b, { { }, { 1, 3, 2 } }), 14);
+    ASSERT_EQ(formaxval(b, { { 1 }, { 3, 1, -1 } }), 5);
+    ASSERT_EQ(forproduct(b, { { 1 }, { 3, 2 } }), 1);
+    ASSERT_EQ(forcount(b > 2, { { }, { 2, 3 } }), 4);
+    // `sum(b(1, :) * b(2, :), mask = b(2, :) > 2)`
+    const auto b_s0 = forstrided<1>(b, { { 1 }, { } });
+    const auto b_s1 = forstrided<1>(b, { { 2 }, { } });
+    ASSERT_EQ(forsum_strided(b_s0.size, [&](const fsize_t(&k)[1]) { return b_s0(k) * b_s1(k); }, [&](const fsize_t(&k)[1]) { return b_s1(k) > 2; }), 42);
+    ASSERT_TRUE(forall_strided(b_s0.size, [&](const fsize_t(&k)[1]) { return b_s0(k) < b_s1(k); }));
+}
+
+int scale(const int x, const int s) {
+    return x * s;
+}
+FOR_ELEMENTAL(scale)
+
+TEST(farray, elemental){
+    farray<int> a{ { 1, 1 },{ 2, 3 },{ 1,2,3,4,5,6 } };
+    farray<int> s{ { 1, 1 },{ 2, 3 },{ 1,1,2,2,3,3 } };
+    ASSERT_EQ(scale(2, 3), 6);
+    // the result has the shape of the first array
+    ASSERT_EQ(scale(a, 2), farray<int>({ 1, 1 }, { 2, 3 }, { 2, 4, 6, 8, 10, 12 }));
+    ASSERT_EQ(scale(3, s), farray<int>({ 1, 1 }, { 2, 3 }, { 3, 3, 6, 6, 9, 9 }));
+    ASSERT_EQ(scale(a, s), farray<int>({ 1, 1 }, { 2, 3 }, { 1, 2, 6, 8, 15, 18 }));
+}
+
+TEST(farray, autoarray){
+    fsize_t n = 3;
+    const int * top;
+    {
+        fautoarray<int, 2> a{ { 1, 0 }, { 2, n } };
+        ASSERT_EQ(a.flatsize(), 6);
+        ASSERT_EQ(a(2, 2), 0);
+        a(2, 2) = 5;
+        fautoarray<int, 1> b{ { 1 }, { n } };
+        // the elements of `b` are right after these of `a` in the arena
+        ASSERT_EQ((const char *)b.cbegin() - (const char *)a.cbegin(), 32);
+        top = b.cbegin();
+        a = a * 2;
+        ASSERT_EQ(a(2, 2), 10);
+        auto twice = [](farray<int> & x) {
+            x *= 2;
+        };
+        twice(a);
+        ASSERT_EQ(a(2, 2), 20);
+    }
+    {
+        // released in the reverse order, so the arena is reused
+        fautoarray<int, 1> c{ { 1 }, { 2 * n } };
+        fautoarray<int, 1> d{ { 1 }, { n } };
+        ASSERT_EQ(d.cbegin(), top);
+        // too large for the arena
+        fautoarray<double, 1> e{ { 1 }, { (fsize_t)farena::max_size } };
+        ASSERT_EQ(e.flatsize(), (fsize_t)farena::max_size);
+        fautoarray<int, 1> f{ { 1 }, { -1 } };
+        ASSERT_EQ(f.flatsize(), 0);
+    }
+}
+
+TEST(farray, component){
+    // `p%y = 1.0`, `p%x = p%y + 1` of a struct-of-arrays `p(4)`
+    fcomponentarray<double> x{ { 1 }, { 4 } }, y{ { 1 }, { 4 } };
+    const double * storage = y.cbegin();
+    y = 1.0;
+    ASSERT_EQ(y.flatsize(), 4);
+    ASSERT_EQ(y.cbegin(), storage);
+    ASSERT_EQ(y(4), 1.0);
+    x = y + 1;
+    y = farray<int>({ 1 }, { 4 }, { 1, 2, 3, 4 });
+    ASSERT_EQ(x.flatsize(), y.flatsize());
+    ASSERT_EQ(x(4), 2.0);
+    ASSERT_EQ(y(4), 4.0);
+}
+
 int main(int argc, char ** argv){
     testing::InitGoogleTest(&argc, argv);
     auto r = RUN_ALL_TESTS();
@@ -128,6 +128,63 @@ TEST(io, implieddo2){
     ASSERT_EQ(RF(), "1 2 3 4 5 6 7 8 9 10\n1 1 1 2\n");
 }
 
+TEST(io, list){
+    farray<int> a{ { 1 },{ 3 } };
+    a(1) = 1; a(2) = 2; a(3) = 3;
+    // generated `write(f, *) 9, (i, a(i), i = 1, 3)`
+    FILE * f = std::fopen(TF, "w");
+    forwritefree_list l(f);
+    l.item(9);
+    for (fsize_t i = 1; i <= 3; i++) {
+        l.item(i);
+        l.item(a(i));
+    }
+    l.end();
+    // generated `write(f, '(3I2)') (a(i), i = 1, 3)`
+    forwrite_list lf(f, IOFormat{ "%2d%2d%2d\n", 0 });
+    for (fsize_t i = 1; i <= 3; i++) {
+        lf.item(a(i));
+    }
+    lf.end();
+    fclose(f);
+    ASSERT_EQ(RF(), "9 1 1 2 2 3 3 \n 1 2 3\n");
+
+    f = std::fopen(TF, "r");
+    forreadfree_list lr(f);
+    for (fsize_t i = 3; i >= 1; i--) {
+        lr.item(&a(i));
+    }
+    lr.end();
+    fclose(f);
+    ASSERT_EQ(a(3), 9);
+    ASSERT_EQ(a(2), 1);
+    ASSERT_EQ(a(1), 1);
+}
+
+TEST(io, list_reversion){
+    // generated `write(*, '(3I2)') (i, i = 1, 6)`, `(i, i = 1, 4)` and `write(10, '(3I2)') (i, i = 1, 4)`
+    FILE * f = std::fopen(TF, "w");
+    forwrite_list l6(f, IOFormat{ "%2d%2d%2d\n", 0 });
+    for (fsize_t i = 1; i <= 6; i++) {
+        l6.item(i);
+    }
+    l6.end();
+    forwrite_list l4(f, IOFormat{ "%2d%2d%2d\n", 0 });
+    for (fsize_t i = 1; i <= 4; i++) {
+        l4.item(i);
+    }
+    l4.end();
+    forwrite_list lu(f, IOFormat{ "%2d%2d%2d\n", 0, 9 });
+    for (fsize_t i = 1; i <= 4; i++) {
+        lu.item(i);
+    }
+    lu.end();
+    fclose(f);
+    // `RF` merges blank lines, so every record end is checked here
+    std::ifstream t(TF);
+    std::string s((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(s, " 1 2 3\n 4 5 6\n 1 2 3\n 4\n 1 2 3\n 4\n");
+}
 
 TEST(io, rewindbackspace){
     FILE * f = fopen(TF, "w");
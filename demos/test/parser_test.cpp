@@ -30,6 +30,19 @@ TEST(Do, All){
 	ASSERT_EQ(LocateNode("0 0")->get_token(), TokenMeta::NT_DO);
 }
 
+TEST(Do, TripCount){
+	ResetParser("integer i, n, m, k\ndo i = 1, n\n  k = k + i\nend do\ndo i = 1, m + 1, k\n  n = n + i\nend do\ndo i = 10, 1, -3\n  n = n + i\nend do\ndo i = 5, 1\n  n = n + i\nend do");
+	std::string code = get_context().program_tree.get_what();
+	// literals and variables are used as they are
+	ASSERT_NE(code.find("i = 1;\n\tfor(fsize_t i_trip = fordo_tripcount(1, n, 1); i_trip > 0; i_trip--, i += 1){"), std::string::npos);
+	// other bounds and the step are evaluated once before the loop
+	ASSERT_NE(code.find("const auto i_to = m + 1;\n\t\tconst auto i_step = k;\n\t\ti = 1;\n\t\tfor(fsize_t i_trip = fordo_tripcount(1, i_to, i_step); i_trip > 0; i_trip--, i += i_step){"), std::string::npos);
+	// the trip count, not `i <= 1`, ends a loop with a negative step
+	ASSERT_NE(code.find("i = 10;\n\tfor(fsize_t i_trip = fordo_tripcount(10, 1, -3); i_trip > 0; i_trip--, i += -3){"), std::string::npos);
+	// `do i = 5, 1` runs zero times
+	ASSERT_NE(code.find("i = 5;\n\tfor(fsize_t i_trip = fordo_tripcount(5, 1, 1); i_trip > 0; i_trip--, i += 1){"), std::string::npos);
+}
+
 TEST(Define, Common){
 	ResetParser(" common /ca/ a, b, c(10)\n common // g");
 	ASSERT_EQ(get_context().commonblocks.size(), 2);
@@ -47,6 +60,23 @@ TEST(Define, Common){
 	ASSERT_EQ(get_context().variables.size(), 6);
 }
 
+TEST(Define, CommonStorage){
+	ResetParser("integer n\nreal*8 b(3, 4)\n common /blk/ n, b\nsubroutine sub\ninteger m\nreal*8 w(12)\n common /blk/ m, w\nend subroutine");
+	CommonBlockInfo * info = get_context().commonblocks["blk"];
+	ASSERT_TRUE(info->storage_associated);
+	ASSERT_EQ(info->layouts.size(), 2);
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("}BLOCK_blk;"), std::string::npos);
+	ASSERT_NE(code.find("double _2[12];"), std::string::npos);
+	ASSERT_NE(code.find("fstaticview<double, fstaticdim<1, 3>, fstaticdim<1, 4>> b{ BLOCK_blk.program._2 };"), std::string::npos);
+	ASSERT_NE(code.find("fstaticview<double, fstaticdim<1, 12>> w{ BLOCK_blk.sub._2 };"), std::string::npos);
+	ASSERT_NE(code.find("int & m = BLOCK_blk.sub._1;"), std::string::npos);
+
+	// a `string` can't share the storage
+	ResetParser(" character*8 s\n common /cs/ s, k");
+	ASSERT_FALSE(get_context().commonblocks["cs"]->storage_associated);
+}
+
 
 TEST(Define, Implicit){
 	ResetParser("implicit integer(a-c)\n a = 1\ni = 1\nd = 1\ninteger e\n");
@@ -93,6 +123,81 @@ TEST(Define, Array){
 	ResetParser("dimension arr(10), j");
 }
 
+TEST(Define, StaticArray){
+	ResetParser("real a(3, 0:2), b(-1:1)\nallocatable c(:)\ninteger n\nreal d(n)");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("fstaticarray<double, fstaticdim<1, 3>, fstaticdim<0, 3>> a"), std::string::npos);
+	ASSERT_NE(code.find("fstaticarray<double, fstaticdim<-1, 3>> b"), std::string::npos);
+	ASSERT_NE(code.find("farray<double> c"), std::string::npos);
+	ASSERT_NE(code.find("farray<double> d"), std::string::npos);
+}
+
+TEST(Define, AutoArray){
+	ResetParser("subroutine s(x, n)\ninteger n\nreal x(n), w(n), t(2, n)\nreal, save :: u(n)\nend subroutine");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("fautoarray<double, 1> w {{1}, {n}};"), std::string::npos);
+	ASSERT_NE(code.find("fautoarray<double, 2> t {{1, 1}, {2, n}};"), std::string::npos);
+	// dummy arguments and saved arrays are not automatic
+	ASSERT_EQ(code.find("fautoarray<double, 1> x"), std::string::npos);
+	ASSERT_NE(code.find("static farray<double> u"), std::string::npos);
+}
+
+TEST(Define, StructOfArrays){
+	ResetParser("!dir$ soa point\ntype point\n  real :: x, y\nend type point\ntype(point) :: p(10)\ndo i = 1, 10\n  p(i)%x = p(i)%y\nend do\np%y = 1.0\nprint *, p(4)%y");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("point_soa p {{1}, {10}};"), std::string::npos);
+	// a whole component is assigned in place
+	ASSERT_NE(code.find("fcomponentarray<double> x;"), std::string::npos);
+	ASSERT_NE(code.find("p.y = 1.0;"), std::string::npos);
+	ASSERT_NE(code.find("double & x;"), std::string::npos);
+	ASSERT_NE(code.find("p(INOUT(i)).x = p(INOUT(i)).y;"), std::string::npos);
+	get_context().parse_config.soa_types.insert("line");
+	ResetParser("type line\n  real :: w(2)\nend type line\ntype point\n  real :: x\nend type point\ntype(line) :: l(10)\ntype(point) :: p(10)");
+	get_context().parse_config.soa_types.clear();
+	code = get_context().program_tree.get_what();
+	// only types given by `--soa`, and whose components are scalars
+	ASSERT_NE(code.find("fstaticarray<line, fstaticdim<1, 10>> l"), std::string::npos);
+	ASSERT_NE(code.find("fstaticarray<point, fstaticdim<1, 10>> p"), std::string::npos);
+	ASSERT_EQ(code.find("_soa"), std::string::npos);
+}
+
+TEST(Define, ArrayBuilder){
+	ResetParser("integer n, d(4)\nreal :: a(4) = (/ 1, 2, 3, 4.5 /)\ninteger :: c(3) = (/ ((i + j, j = 1, 1), i = 1, 3) /)\nreal b(n)\nb = (/ 0.0, (i * 2.0, i = 1, n - 1) /)\nd = (/ c, 1 /)\nd = (/ (i, i = 1, 4) /) * 2");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("static const double a_init[] = {1.0, 2.0, 3.0, 4.5};"), std::string::npos);
+	ASSERT_NE(code.find("b_flat[b_k++] = 0.0;"), std::string::npos);
+	ASSERT_NE(code.find("for(fsize_t i = 1; i <= n - 1; i++){"), std::string::npos);
+	ASSERT_NE(code.find("c_flat[c_k++] = i + j;"), std::string::npos);
+	// `c` is an array
+	ASSERT_EQ(code.find("d_flat"), std::string::npos);
+	// the implied-do variable keeps its type, so the constructor is not an array of `fsize_t`
+	ASSERT_NE(code.find("return [&](int i){"), std::string::npos);
+}
+
+TEST(Define, Parameter){
+	ResetParser("integer, parameter :: n = 4, m = n * 2 + 1\nreal a(n, 0:m)\ndo i = 1, m - 1\n  a(1, i) = n / 3\nend do");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("constexpr int m = 9;"), std::string::npos);
+	ASSERT_NE(code.find("fstaticarray<double, fstaticdim<1, 4>, fstaticdim<0, 10>> a"), std::string::npos);
+	ASSERT_NE(code.find("fordo_tripcount(1, 8, 1)"), std::string::npos);
+	ASSERT_NE(code.find("a(INOUT(1), INOUT(i)) = 1;"), std::string::npos);
+}
+
+TEST(Define, NegParameter){
+	// unary `-` binds as binary `+` and `-`, `-a - b` is `(-a) - b`
+	ResetParser("integer, parameter :: n = 4, a = -2 - 3, b = -2 + 1, c = -n + 1\ninteger k\ndo k = -n + 5, 10\n  print *, k\nend do");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("constexpr int a = -5;"), std::string::npos);
+	ASSERT_NE(code.find("constexpr int b = -1;"), std::string::npos);
+	ASSERT_NE(code.find("constexpr int c = -3;"), std::string::npos);
+	ASSERT_NE(code.find("fordo_tripcount(1, 10, 1)"), std::string::npos);
+	get_context().parse_config.openmp = true;
+	ResetParser("integer k\n!$omp parallel do\ndo k = 10, 1, -2 + 1\n  print *, k\nend do\n!$omp end parallel do");
+	code = get_context().program_tree.get_what();
+	get_context().parse_config.openmp = false;
+	ASSERT_NE(code.find("for(k = 10; k >= 1; k += -1){"), std::string::npos);
+}
+
 TEST(Define, Kind){
 	ResetParser("integer(kind=2)::i = int(j)");
 	ASSERT_EQ(get_context().variables.size(), 2);
@@ -102,6 +207,31 @@ TEST(Define, Kind){
 	ASSERT_EQ(get_context().variables["::program::d"]->type.get_what(), "double");
 }
 
+TEST(Define, RealKind){
+	ResetParser("integer, parameter :: dp = 8\nreal(4) a\nreal*8 b\nreal(kind=dp) c\nreal(16) q\ndouble precision d\nreal r\na = 1.5 + b\nb = 1.0d-3\nc = 2.0_dp / 3\nq = 1.0_16\nr = real(a) + dble(a) + real(b, 4)");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_EQ(get_context().variables["::program::a"]->type.get_what(), "float");
+	ASSERT_EQ(get_context().variables["::program::b"]->type.get_what(), "double");
+	ASSERT_EQ(get_context().variables["::program::c"]->type.get_what(), "double");
+	ASSERT_EQ(get_context().variables["::program::q"]->type.get_what(), "long double");
+	ASSERT_EQ(get_context().variables["::program::d"]->type.get_what(), "double");
+	ASSERT_EQ(get_context().variables["::program::r"]->type.get_what(), "double");
+	ASSERT_NE(code.find("b = 1.0e-3;"), std::string::npos);
+	ASSERT_NE(code.find("q = 1.0L;"), std::string::npos);
+	ASSERT_NE(code.find("to_double(a) + to_double(a) + to_float(b)"), std::string::npos);
+
+	get_context().parse_config.default_real_kind = 4;
+	ResetParser("real, parameter :: h = 0.1 * 3\nreal a\ndouble precision d\na = h + 1.0 + 2.0d0\nd = x");
+	get_context().parse_config.default_real_kind = 8;
+	code = get_context().program_tree.get_what();
+	ASSERT_EQ(get_context().variables["::program::a"]->type.get_what(), "float");
+	ASSERT_EQ(get_context().variables["::program::d"]->type.get_what(), "double");
+	ASSERT_EQ(get_context().variables["::program::x"]->type.get_what(), "float");
+	ASSERT_NE(code.find("constexpr float h = 0.3f;"), std::string::npos);
+	// `0.3f + 1.0f` is folded as `float`
+	ASSERT_NE(code.find("a = 3.299999952316284;"), std::string::npos);
+}
+
 std::string get_typestr(std::string type_name, bool in_paramtable){
 	return gen_qualified_typestr(get_context().variables[type_name]->type, get_context().variables[type_name]->desc, in_paramtable);
 }
@@ -118,8 +248,7 @@ TEST(Define, Qualifier){
 	ASSERT_EQ(get_typestr("::program::i", false), "int &");
 	ResetParser("integer, intent(inout)::i = arr(1)");
 	ASSERT_EQ(get_context().variables["::program::i"]->desc.inout_reference, true);
-	// TODO Check if error here?
-	ASSERT_EQ(get_typestr("::program::i", false), "int &&");
+	ASSERT_EQ(get_typestr("::program::i", false), "int &");
 	ResetParser("integer, optional::i = arr(1)");
 	ASSERT_EQ(get_context().variables["::program::i"]->desc.optional, true);
 	ASSERT_EQ(get_typestr("::program::i", false), "foroptional<int>");
@@ -130,13 +259,14 @@ TEST(Define, Qualifier){
 	ASSERT_EQ(get_context().variables["::f::i"]->desc.save, true);
 	ResetParser("subroutine f(i)\ninteger, intent(in)::i = 1\nendsubroutine");
 	ASSERT_EQ(get_context().variables["::f::i"]->desc.reference, true);
-	ASSERT_EQ(get_typestr("::f::i", true), "const int &");
+	// `intent(in)` scalars are passed by value
+	ASSERT_EQ(get_typestr("::f::i", true), "const int");
 	ResetParser("subroutine f(i)\ninteger, intent(out)::i = arr(1)\nendsubroutine");
 	ASSERT_EQ(get_context().variables["::f::i"]->desc.reference, true);
 	ASSERT_EQ(get_typestr("::f::i", true), "int &");
 	ResetParser("subroutine f(i)\ninteger, intent(inout)::i = arr(1)\nendsubroutine");
 	ASSERT_EQ(get_context().variables["::f::i"]->desc.inout_reference, true);
-	ASSERT_EQ(get_typestr("::f::i", true), "int &&");
+	ASSERT_EQ(get_typestr("::f::i", true), "int &");
 	ResetParser("subroutine f(i)\ninteger, optional::i = arr(1)\nendsubroutine");
 	ASSERT_EQ(get_context().variables["::f::i"]->desc.optional, true);
 	ASSERT_EQ(get_typestr("::f::i", true), "foroptional<int>");
@@ -144,6 +274,17 @@ TEST(Define, Qualifier){
 	ASSERT_EQ(get_typestr("::f::i", true), "int &&");
 }
 
+TEST(Define, Save){
+	ResetParser("subroutine f\nreal*8, save :: w(3) = (/ 1.0d0, 2.0d0, 3.0d0 /)\ninteger :: k = 5\nreal*8 v(2)\ndata v / 1.0d0, 2.0d0 /\nendsubroutine");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_EQ(get_context().variables["::f::k"]->desc.save, true);
+	ASSERT_NE(code.find("static int k = 5;"), std::string::npos);
+	ASSERT_NE(code.find("static fstaticarray<double, fstaticdim<1, 3>> w {};"), std::string::npos);
+	ASSERT_NE(code.find("static const bool w_initialized = [&]() {"), std::string::npos);
+	ASSERT_NE(code.find("static fstaticarray<double, fstaticdim<1, 2>> v {};"), std::string::npos);
+	ASSERT_NE(code.find("static const bool data_5 = [&]() {"), std::string::npos);
+}
+
 TEST(Fixed, Comment){
 	ResetParser("character c");
 	ResetParser("common /a/ a");
@@ -189,6 +330,168 @@ TEST(Statement, Basic){
 	ResetParser("pause\nstop\ncontinue");
 }
 
+TEST(Statement, LineDirective){
+	get_context().parse_config.line_directive = true;
+	get_context().parse_config.filename = "t.for";
+	ResetParser("a = 1\nif (a > 0) then\n  b = 2\nend if");
+	std::string code = get_context().program_tree.get_what();
+	get_context().parse_config.line_directive = false;
+	ASSERT_NE(code.find("#line 1 \"t.for\"\n\ta = 1;"), std::string::npos);
+	ASSERT_NE(code.find("#line 2 \"t.for\"\n\tif"), std::string::npos);
+	ASSERT_NE(code.find("#line 3 \"t.for\"\n\t\tb = 2;"), std::string::npos);
+
+	get_context().parse_config.line_directive = true;
+	get_context().parse_config.filename = "";
+	ResetParser("a = 1");
+	code = get_context().program_tree.get_what();
+	get_context().parse_config.line_directive = false;
+	ASSERT_NE(code.find("#line 1\n\ta = 1;"), std::string::npos);
+
+	// a source of the same length as the first one, whose lines start elsewhere, and a file name to escape
+	get_context().parse_config.line_directive = true;
+	get_context().parse_config.filename = "d\\\"t\".for";
+	ResetParser("\na = 1\nif (a > 0) then\n b = 2\nend if");
+	code = get_context().program_tree.get_what();
+	get_context().parse_config.line_directive = false;
+	get_context().parse_config.filename = "";
+	ASSERT_NE(code.find("#line 2 \"d\\\\\\\"t\\\".for\"\n\ta = 1;"), std::string::npos);
+	ASSERT_NE(code.find("#line 4 \"d\\\\\\\"t\\\".for\"\n\t\tb = 2;"), std::string::npos);
+}
+
+TEST(Statement, OpenMP){
+	get_context().parse_config.openmp = true;
+	ResetParser("!$omp parallel do reduction(+:s) &\n!$omp& schedule(static)\ndo j = 1, n\n  do i = 1, n\n    s = s + i\n  end do\nend do\n!$omp end parallel do\n!$omp parallel\n!$omp critical\ns = s + 1\n!$omp end critical\n!$omp end parallel");
+	std::string code = get_context().program_tree.get_what();
+	get_context().parse_config.openmp = false;
+	ASSERT_NE(code.find("#pragma omp parallel for reduction(+:s) schedule(static) private(i)\n\tfor(j = 1; j <= n; j += 1){"), std::string::npos);
+	ASSERT_NE(code.find("#pragma omp parallel\n\t{\n#pragma omp critical\n\t\t{\n\t\t\ts = s + 1;"), std::string::npos);
+	get_context().parse_config.openmp = true;
+	ResetParser("subroutine s(n, r)\ninteger n\nreal r(n), tmp(n)\n!$omp parallel do private(tmp, k)\ndo i = 1, n\n  do k = 1, n\n    tmp(k) = i * k\n  end do\n  r(i) = sum(tmp)\nend do\n!$omp end parallel do\nend subroutine");
+	code = get_context().program_tree.get_what();
+	get_context().parse_config.openmp = false;
+	// the copy of the automatic array `tmp` has its shape
+	ASSERT_NE(code.find("fautoarray<double, 1> tmp"), std::string::npos);
+	ASSERT_NE(code.find("#pragma omp parallel for private(k) firstprivate(tmp)"), std::string::npos);
+}
+
+TEST(Statement, DoConcurrent){
+	ResetParser("real a(10), b(10), c(10, 10)\ndo concurrent (i = 1:10, j = 1:n:2, a(i) > 0)\n  if (j > 5) cycle\n  t = a(i)\n  b(i) = t\nend do\nforall (i = 2:10) a(i) = a(i - 1)\nforall (i = 1:10)\n  b(i) = a(i)\nend forall\nforall (i = 1:10, a(i) > 0)\n  forall (j = 1:10)\n    c(i, j) = b(j)\n  end forall\nend forall");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("forconcurrent({1, 1}, {10, n}, {1, 2}, [&, t](fsize_t i, fsize_t j) mutable{"), std::string::npos);
+	ASSERT_NE(code.find("return;"), std::string::npos);
+	// `a` is read, so every value is evaluated before assignment
+	ASSERT_NE(code.find("forall_assign({2}, {10}, {1}"), std::string::npos);
+	ASSERT_NE(code.find("forconcurrent({1}, {10}, {1}, [&](fsize_t i){"), std::string::npos);
+	// the nested forall runs only for the indexes selected by the outer mask
+	ASSERT_NE(code.find("forall_nested({1}, {10}, {1}, [&](fsize_t i){ return a(INOUT(i)) > 0; }, [&](fsize_t i){"), std::string::npos);
+}
+
+TEST(Statement, AutoPar){
+	get_context().parse_config.autopar = true;
+	ResetParser("real a(10), b(10)\ns = 0\ndo i = 1, 10\n  t = b(i)\n  a(i) = t * 2\n  s = s + t\nend do\ndo i = 2, 10\n  a(i) = a(i - 1)\nend do");
+	std::string code = get_context().program_tree.get_what();
+	get_context().parse_config.autopar = false;
+	ASSERT_NE(code.find("forconcurrent_reduce({1}, {10}, {1}, s, forreduce_add(), [&, t](auto & s, fsize_t i) mutable{"), std::string::npos);
+	// `a(i - 1)` is written by the previous iteration
+	ASSERT_NE(code.find("for(fsize_t i_trip = fordo_tripcount(2, 10, 1)"), std::string::npos);
+	// a prefix sum reads the partial value of `s`
+	get_context().parse_config.autopar = true;
+	ResetParser("real a(10), b(10)\ns = 0\ndo i = 1, n\n  s = s + b(i)\n  a(i) = s\nend do");
+	code = get_context().program_tree.get_what();
+	get_context().parse_config.autopar = false;
+	ASSERT_EQ(code.find("forconcurrent_reduce"), std::string::npos);
+	ASSERT_NE(code.find("for(fsize_t i_trip = fordo_tripcount(1, n, 1)"), std::string::npos);
+	// `a` and `b` may be passed the same array, `q` may be written through a pointer
+	get_context().parse_config.autopar = true;
+	ResetParser("subroutine s(n, a, b)\ninteger n\nreal a(n), b(n), t(10)\nreal, target :: q(10)\ndo i = 1, n\n  a(i) = b(i)\nend do\ndo i = 1, 10\n  q(i) = 1\nend do\ndo i = 1, 10\n  t(i) = b(i)\nend do\nend subroutine");
+	code = get_context().program_tree.get_what();
+	get_context().parse_config.autopar = false;
+	ASSERT_NE(code.find("for(fsize_t i_trip = fordo_tripcount(1, n, 1)"), std::string::npos);
+	ASSERT_NE(code.find("for(fsize_t i_trip = fordo_tripcount(1, 10, 1)"), std::string::npos);
+	ASSERT_NE(code.find("forconcurrent({1}, {10}, {1}, [&](fsize_t i){"), std::string::npos);
+}
+
+TEST(Statement, Scalarize){
+	ResetParser("real a(10), b(10), c(1:10), d(0:10)\na = b + 2 * c\nd = a + 1");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("a_flat[a_k] = b_flat[a_k] + 2 * c_flat[a_k];"), std::string::npos);
+	// `d` has 11 elements, so `d = a + 1` is left to farray
+	ASSERT_NE(code.find("d = a + 1;"), std::string::npos);
+}
+
+TEST(Statement, Where){
+	ResetParser("real a(10), b(10)\nwhere (a > 0)\n  b = a\nelsewhere\n  b = 0\nend where\nwhere (a < 1) a = 1");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("if (a_flat[a_k] > 0) {"), std::string::npos);
+	ASSERT_NE(code.find("if (a_flat[a_k] < 1) {"), std::string::npos);
+	ASSERT_EQ(code.find("farray<bool>"), std::string::npos);
+	// sections are assigned through the masked loop
+	ResetParser("real a(10), b(10)\nwhere (a > 0) b = a(10:1:-1)\nwhere (a > 0) b(1:10) = 0");
+	code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("const auto where_value = forslice(a, {{10, 1, -1}});"), std::string::npos);
+	ASSERT_NE(code.find("auto where_section = forsection(b, {{1, 10}});"), std::string::npos);
+	ASSERT_NE(code.find("farray<double> & where_lhs = where_section;"), std::string::npos);
+	ASSERT_NE(code.find("where_lhs.begin()[where_k] = 0;"), std::string::npos);
+}
+
+TEST(Statement, Reduction){
+	ResetParser("integer n\nreal a(10), b(4, 5), s\ns = sum(a(2:n))\ns = sum(a(2:n), mask = a(2:n) > 0)\nn = count(b(2, :) > 0)\ns = sum(b, 1)");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("s = forsum(a, {{2, n}});"), std::string::npos);
+	ASSERT_NE(code.find("const auto a_s0 = forstrided<1>(a, {{2, n}}); return forsum_strided(a_s0.size, [&](const fsize_t(&reduce_k)[1]){ return a_s0(reduce_k); }, [&](const fsize_t(&reduce_k)[1]){ return a_s0(reduce_k) > 0; });"), std::string::npos);
+	ASSERT_NE(code.find("const auto b_s0 = forstrided<1>(b, {{2}, {}}); return forcount_strided("), std::string::npos);
+	// a reduction along `dim` is left to farray
+	ASSERT_NE(code.find("s = forsum(b, 1"), std::string::npos);
+	ASSERT_EQ(code.find("forslice"), std::string::npos);
+}
+
+TEST(Statement, RankAccessor){
+	ResetParser("integer n\nreal a(n, n), b(n)\ndo j = 1, n\n  do i = 1, n\n    a(i, j) = b(i)\n  end do\nend do\ndo i = 1, n\n  b(i) = sum(b)\nend do");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("auto a_at = forrank<2>(a);"), std::string::npos);
+	ASSERT_NE(code.find("a_at(i, j) = b_at(i);"), std::string::npos);
+	// `b` is used as a whole in the second loop
+	ASSERT_NE(code.find("b(INOUT(i)) = "), std::string::npos);
+}
+
+TEST(Statement, Select){
+	ResetParser("integer i, k\ncharacter*8 s\nselect case (i * 2)\n  case (1, 3:4)\n    k = 1\n  case (10:1000)\n    k = 2\n  case default\n    k = 3\nend select\nselect case (s)\n  case ('a ', 'b')\n    k = 1\nend select\ndo i = 1, 10\n  select case (i)\n    case (5)\n      exit\n  end select\nend do");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("const auto select_value = i * 2;"), std::string::npos);
+	ASSERT_NE(code.find("switch (select_value) {"), std::string::npos);
+	ASSERT_NE(code.find("case 3:"), std::string::npos);
+	ASSERT_NE(code.find("case 4:"), std::string::npos);
+	// a large range is not expanded
+	ASSERT_NE(code.find("if((select_value >= 10 && select_value <= 1000)){"), std::string::npos);
+	ASSERT_NE(code.find("static const forselect_table select_cases{ { \"a\", 1 }, { \"b\", 1 } };"), std::string::npos);
+	// `break` can't leave the loop from a `switch`
+	ASSERT_NE(code.find("if(select_value == 5){"), std::string::npos);
+}
+
+TEST(Statement, Goto){
+	ResetParser("      integer i, s\n  100 s = s + i\n      i = i + 1\n      if (i <= 10) goto 100\n  200 if (i >= 20) goto 300\n      i = i + 2\n      goto 200\n  300 if (s > 100) goto 400\n      s = -s\n  400 if (i) 10, 20, 30\n   10 goto (20, 30), s\n   20 s = 0\n   30 s = 1");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("} while (i <= 10);"), std::string::npos);
+	ASSERT_NE(code.find("while (!(i >= 20)) {"), std::string::npos);
+	ASSERT_NE(code.find("if (!(s > 100)) {"), std::string::npos);
+	ASSERT_NE(code.find("switch ((if_value > 0) - (if_value < 0)) {"), std::string::npos);
+	ASSERT_NE(code.find("switch ((int)(s)) {"), std::string::npos);
+	ASSERT_EQ(code.find("LABEL_program_100"), std::string::npos);
+	ASSERT_NE(code.find("LABEL_program_20:"), std::string::npos);
+}
+
+TEST(Statement, RestrictDummies){
+	get_context().parse_config.restrict_dummies = true;
+	ResetParser("subroutine s(a, b, n)\ninteger n\nreal a(n), b(n), w(n)\ndo i = 1, n\n  a(i) = b(i) + w(i)\nend do\ndo i = 1, n\n  if (a(i) > 0) return\nend do\nend subroutine");
+	std::string code = get_context().program_tree.get_what();
+	get_context().parse_config.restrict_dummies = false;
+	ASSERT_NE(code.find("auto w_at = forrank<1>(w);"), std::string::npos);
+	ASSERT_NE(code.find("[&](auto a_at, auto b_at){"), std::string::npos);
+	ASSERT_NE(code.find("}(forrank_restrict<1>(a), forrank_restrict<1>(b));"), std::string::npos);
+	// `return` can't leave a lambda
+	ASSERT_NE(code.find("auto a_at = forrank<1>(a);"), std::string::npos);
+}
+
 TEST(IO, Format){
 	// `write` can use format defined later at label `12`.
 	ResetParser("11    write(*, 12) a, b, c, arr(1), a, b, c, arr(2)\n12    format(2(3I,F))");
@@ -204,6 +507,17 @@ TEST(IO, Format){
 	ResetParser("write(2,*) ((a(i,j), j=1,i), i=1,10)");
 }
 
+TEST(IO, ImpliedDo){
+	ResetParser("integer n, a(10, 10)\nwrite(*, *) n, ((a(i, j), j = 1, i), i = 1, n)\nread(1, '(3I5)') (a(i, 1), i = 1, 3)");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("forwritefree_list io_list(stdout);"), std::string::npos);
+	ASSERT_NE(code.find("io_list.item(n);"), std::string::npos);
+	ASSERT_NE(code.find("for(fsize_t j = 1; j <= i; j++){"), std::string::npos);
+	ASSERT_NE(code.find("forread_list io_list(get_file(1), IOFormat{"), std::string::npos);
+	ASSERT_NE(code.find("io_list.item(&a("), std::string::npos);
+	ASSERT_EQ(code.find("make_implieddo"), std::string::npos);
+}
+
 
 TEST(Paramtable, Basic){
 	ResetParser("A(1, 2, 3)");
@@ -221,6 +535,45 @@ TEST(Function, Define){
 	ASSERT_EQ(get_context().functions["::t"]->funcdesc.declared_variables.size(), 3);
 }
 
+TEST(Function, ArgumentPassing){
+	ResetParser("subroutine f(n, s, x, y)\ninteger, intent(in) :: n\nreal, intent(in) :: s, x(n)\nreal, intent(inout) :: y(n)\nend subroutine\nreal a(4, 4), b(4)\n  call f(4, 2.0, b, a(:, 2))\n  call f(4, 2.0, a(1, :), b)");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("void f(const int n, const double s, const farray<double> & x, farray<double> & y)"), std::string::npos);
+	ASSERT_NE(code.find("f(INOUT(4), INOUT(2.0), INOUT(b), forsection(a, {{}, {2}}));"), std::string::npos);
+	ASSERT_NE(code.find("f(INOUT(4), INOUT(2.0), forsection(a, {{1}, {}}), INOUT(b));"), std::string::npos);
+}
+
+TEST(Function, Pure){
+	ResetParser("elemental real function f(x)\nreal, intent(in) :: x\nf = x * 2\nend function\npure real function g(n, v)\ninteger, intent(in) :: n\nreal, intent(in) :: v(n)\ng = v(1)\nend function\nreal a(4), b(4)\n  b = f(a) + 1\n  print *, g(4, a)");
+	std::string code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("inline FOR_CONST double f(const double x)"), std::string::npos);
+	ASSERT_NE(code.find("FOR_ELEMENTAL(f)"), std::string::npos);
+	ASSERT_NE(code.find("inline FOR_PURE double g(const int n, const farray<double> & v)"), std::string::npos);
+	// elemental calls in a whole array assignment are made in the loop
+	ASSERT_NE(code.find("b_flat[b_k] = f(a_flat[b_k]) + 1;"), std::string::npos);
+	ASSERT_NE(code.find("g(IN(4), IN(a))"), std::string::npos);
+	// `f` reads `c` through `g`, `h` calls `k`, which reads only its argument
+	ResetParser("pure real function g(x)\nreal, intent(in) :: x\nreal c\n  common /blk/ c\ng = x + c\nend function\npure real function f(x)\nreal, intent(in) :: x\nf = g(x) * 2\nend function\npure real function h(x)\nreal, intent(in) :: x\nh = sqrt(x) + k(x)\nend function\npure real function k(x)\nreal, intent(in) :: x\nk = x * 2\nend function\nprint *, f(1.0), h(2.0)");
+	code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("inline FOR_PURE double f(const double x)"), std::string::npos);
+	ASSERT_NE(code.find("inline FOR_CONST double h(const double x)"), std::string::npos);
+	// `f` reads `k` of its module, `g` declares its own `k`
+	ResetParser("module m\n  real k\n  contains\n  pure real function f(x)\n    real, intent(in) :: x\n    f = x * k\n  end function\n  pure real function g(x)\n    real, intent(in) :: x\n    real k\n    k = 2\n    g = x * k\n  end function\nend module");
+	code = get_context().program_tree.get_what();
+	ASSERT_NE(code.find("inline FOR_PURE double f(const double x)"), std::string::npos);
+	ASSERT_NE(code.find("inline FOR_CONST double g(const double x)"), std::string::npos);
+}
+
+TEST(Function, Instrument){
+	get_context().parse_config.instrument = true;
+	ResetParser("pure real function f(x)\nreal, intent(in) :: x\nf = x * 2\nend function\nsubroutine s\nend subroutine\ncall s\nprint *, f(1.0)");
+	std::string code = get_context().program_tree.get_what();
+	get_context().parse_config.instrument = false;
+	ASSERT_NE(code.find("inline double f(const double x)\n{\n\tFOR_PROFILE(\"f\");"), std::string::npos);
+	ASSERT_NE(code.find("void s()\n{\n\tFOR_PROFILE(\"s\");"), std::string::npos);
+	ASSERT_NE(code.find("int main()\n{\n\tFOR_PROFILE(\"program\");"), std::string::npos);
+}
+
 TEST(Function, Interface){
 }
 
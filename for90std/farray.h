@@ -21,6 +21,7 @@
 #include <memory>
 #include <cmath>
 #include <cassert>
+#include <optional>
 #include "fordefs.h"
 #include "forarray_common.h"
 #include "forlang.h"
@@ -341,7 +342,13 @@ struct farray {
 			}
 			na[newindex] = parr[oldindex];
 		});
-		std::swap(na, parr);
+		if (fixed)
+		{
+			std::copy_n(na, flatsize(), parr);
+		}
+		else {
+			std::swap(na, parr);
+		}
 		delete[] na;
 		//std::reverse(begin(), end());
 		std::reverse(lb, lb + dimension);
@@ -372,6 +379,7 @@ struct farray {
 	template<int X>
 	void reset_array(const slice_info<fsize_t>(&tp)[X], bool force_lower_bound = false) {
 		// this overload do not provide dimension parameter, because dimension is dependant on `tp`
+		assert(!fixed);
 		delete[] lb; delete[] sz; delete[] delta;
 		// modify dimension because not all element of tp is slice, probably index instead
 		dimension = 0;
@@ -408,7 +416,7 @@ struct farray {
 			if ((tp[i]).isslice)
 			{
 				const slice_info<fsize_t> & x = tp[i];
-				sz[dim++] = (x.to + 1 - x.fr) / x.step + ((x.to + 1 - x.fr) % x.step == 0 ? 0 : 1);
+				sz[dim++] = fordo_tripcount(x.fr, x.to, x.step);
 			}
 		}
 		fa_layer_delta(this->sz, this->sz + dimension, delta);
@@ -416,6 +424,7 @@ struct farray {
 
 	template <typename Iterator_FSize_T>
 	void reset_array(int dim, Iterator_FSize_T l, Iterator_FSize_T s) {
+		assert(!fixed);
 		this->dimension = dim;
 		delete[] lb; delete[] sz; delete[] delta;
 		lb = new fsize_t[dim]; sz = new fsize_t[dim]; delta = new fsize_t[dim];
@@ -428,23 +437,35 @@ struct farray {
 	}
 
 	void clear() {
+		if (fixed)
+		{
+			// storage of `fstaticarray` is never released
+			return;
+		}
 		delete[] parr;
 		parr = nullptr;
 	}
 	void reset_value(const T & value) {
-		clear();
-		parr = new T[flatsize()];
+		if (!fixed)
+		{
+			clear();
+			parr = new T[flatsize()];
+		}
 		std::fill_n(parr, flatsize(), value);
 	}
 	void reset_value(int X, const farray<T> * farrs) {/*lbound and sz not modified, need make sure the sum of farrs' flatten size be the same with old flat size*/
 		// reset value from several arrays
-		clear();
 		fsize_t flatsize = 0;
 		for (int i = 0; i < X; i++)
 		{
 			flatsize += farrs[i].flatsize();
 		}
-		this->parr = new T[flatsize]();
+		if (!fixed)
+		{
+			clear();
+			this->parr = new T[flatsize]();
+		}
+		assert(flatsize == this->flatsize());
 		T * parr_iter = parr;
 		for (int i = 0; i < X; i++)
 		{
@@ -454,20 +475,31 @@ struct farray {
 	}
 	template <typename Iterator>
 	void reset_value(Iterator b, Iterator e) {
+		if (fixed)
+		{
+			std::copy_n(b, std::min<fsize_t>(e - b, flatsize()), parr);
+			return;
+		}
 		clear();
 		parr = new T[flatsize()];
 		std::copy_n(b, e - b, parr);
 	}
 	void reset_value() {
 		// allocate only according to sz
+		if (fixed)
+		{
+			std::fill_n(parr, flatsize(), T{});
+			return;
+		}
 		clear();
 		fsize_t totalsize = flatsize();
 		parr = new T[totalsize]{};
 	}
-	template <typename Iterator_FSize_T>
+	template <typename Iterator_FSize_T, typename = std::enable_if_t<!std::is_integral<Iterator_FSize_T>::value>>
 	farray(int D, Iterator_FSize_T lower_bound, Iterator_FSize_T size) noexcept: is_view(false)
 	{
 		// on some occations, dimension is not given by sizeof(lower_bound) / sizeof(size)
+		// integers are not iterators, so `formaxval(a, {{1, n, 2}})` is not taken as a mask
 		reset_array(D, lower_bound, size);
 		reset_value();
 	}
@@ -526,9 +558,27 @@ struct farray {
 	//}
 	farray() noexcept: is_view(false) {
 
+	}
+	farray(T * storage, int D, size_type * lower_bound, size_type * size, size_type * delta) noexcept : is_view(true) {
+		// a view of `storage` of shape `size`, ref `forsection`
+		// like `fstaticarray`, the storage and shape are owned by the caller, so they are never released
+		this->dimension = D;
+		std::fill_n(lower_bound, D, 1);
+		fa_layer_delta(size, size + D, delta);
+		this->lb = lower_bound;
+		this->sz = size;
+		this->delta = delta;
+		this->parr = storage;
+		this->fixed = true;
 	}
 	farray<T> & copy_from(const farray<T> & x) {
 		if (this == &x) return *this;
+		if (fixed)
+		{
+			assert(x.flatsize() == flatsize());
+			reset_value(x.cbegin(), x.cend());
+			return *this;
+		}
 		this->dimension = x.dimension;
 		reset_array(this->dimension, x.LBound(), x.size());
 		reset_value(x.cbegin(), x.cend());
@@ -538,8 +588,20 @@ struct farray {
 		// copy constructor
 		copy_from(m);
 	}
+	template <typename R>
+	explicit farray(const farray<R> & m) : is_view(false) {
+		// copy and convert, e.g. the `farray<fsize_t>` of `forshape` to `farray<int>`
+		this->dimension = m.dimension;
+		reset_array(m.dimension, m.LBound(), m.size());
+		reset_value(m.cbegin(), m.cend());
+	}
 	farray<T> & move_from(farray<T> && m) {
 		if (this == &m) return *this;
+		if (fixed || m.fixed)
+		{
+			// storage of `fstaticarray` can't be stolen or replaced
+			return fixed ? (*this = m) : copy_from(m);
+		}
 		delete[] lb; delete[] sz; delete[] delta;
 		clear();
 		this->dimension = m.dimension;
@@ -580,12 +642,21 @@ struct farray {
 		// only reset value, remain original shape
 		// use `move_from`, or call `reset_array` before using `operator=`, if you want to move the entire array
 		if (this == &x) return *this;
+		if (fixed || x.fixed)
+		{
+			reset_value(x.cbegin(), x.cend());
+			return *this;
+		}
 		delete [] this->parr;
 		this->parr = x.parr;
 		x.parr = nullptr;
 		return *this;
 	}
 	~farray() {
+		if (fixed)
+		{
+			return;
+		}
 		if (!is_view) {
 			delete[] parr;
 			parr = nullptr;
@@ -595,9 +666,123 @@ struct farray {
 	T * parr = nullptr; // support inplace operation of each element
 protected:
 	size_type * lb = nullptr, * sz = nullptr, * delta = nullptr;
+	// `parr`, `lb`, `sz` and `delta` point to storage of a `fstaticarray`, the shape never changes
+	bool fixed = false;
 
 };
 
+// true for `farray<T>` and arrays derived from it, like `fstaticarray`
+// overloads taking any `const T &` must exclude them, else they are a better match than `const farray<T> &`
+template <typename T>
+std::true_type _is_farray_impl(const farray<T> *);
+std::false_type _is_farray_impl(...);
+template <typename X>
+struct is_farray : decltype(_is_farray_impl(std::declval<std::decay_t<X> *>())) {};
+#define _NOT_FARRAY(X) typename = std::enable_if_t<!is_farray<X>::value>
+
+/****************
+* the array of one component of a struct-of-arrays, ref `gen_soa_definition`
+*	all components of `p` share the shape of `p`, so `p%x = v` writes into the existing elements
+*	, a scalar is broadcast, and an array is never bound or stolen
+****************/
+template <typename T>
+struct fcomponentarray : public farray<T> {
+	fcomponentarray() noexcept { }
+	template <int D>
+	fcomponentarray(const fsize_t(&lower_bound)[D], const fsize_t(&size)[D]) noexcept : farray<T>(lower_bound, size) { }
+	fcomponentarray(const fcomponentarray & m) noexcept : farray<T>(m) { }
+	fcomponentarray & operator=(const T & scalar) {
+		std::fill_n(this->begin(), this->flatsize(), scalar);
+		return *this;
+	}
+	fcomponentarray & operator=(const farray<T> & x) {
+		assert(x.flatsize() == this->flatsize());
+		std::copy_n(x.cbegin(), this->flatsize(), this->begin());
+		return *this;
+	}
+	fcomponentarray & operator=(farray<T> && x) {
+		return *this = static_cast<const farray<T> &>(x);
+	}
+	fcomponentarray & operator=(const fcomponentarray & x) {
+		return *this = static_cast<const farray<T> &>(x);
+	}
+	template <typename R>
+	fcomponentarray & operator=(const farray<R> & x) {
+		assert(x.flatsize() == this->flatsize());
+		std::copy_n(x.cbegin(), this->flatsize(), this->begin());
+		return *this;
+	}
+};
+
+/****************
+* elements of a farray whose rank `R` is known by the translator
+*	the data pointer and strides are copied into the accessor, so in a loop they stay in registers
+*	, instead of being reloaded from the heap after each store to an element
+*	the first dimension is contiguous, so `a(i, j)` is `parr[i + j * stride[1] - base]`
+*	the array must not be reallocated while the accessor is used
+*	`Pointer` is `T * __restrict` for `forrank_restrict`
+****************/
+template <typename T, int R, typename Pointer = T *>
+struct farray_accessor {
+	farray_accessor(T * parr, const fsize_t * lb, const fsize_t * delta) noexcept : parr(parr) {
+		assert(delta[0] == 1);
+		base = lb[0];
+		for (int i = 1; i < R; i++)
+		{
+			stride[i] = delta[i];
+			base += lb[i] * delta[i];
+		}
+	}
+	template<typename... Args>
+	T & operator()(Args&&... args) const {
+		static_assert(sizeof...(Args) == R, "wrong number of subscripts");
+		const fsize_t index[R] = { (fsize_t)args... };
+		fsize_t off = index[0] - base;
+		for (int i = 1; i < R; i++)
+		{
+			off += index[i] * stride[i];
+		}
+		return parr[off];
+	}
+
+private:
+	Pointer parr;
+	fsize_t base; // flat offset of element `(0, 0, ...)`
+	fsize_t stride[R];
+};
+
+template <int R, typename T>
+farray_accessor<T, R> forrank(farray<T> & farr) {
+	assert(farr.dimension == R);
+	return farray_accessor<T, R>(farr.begin(), farr.LBound(), farr.get_delta());
+}
+template <int R, typename T>
+farray_accessor<const T, R> forrank(const farray<T> & farr) {
+	assert(farr.dimension == R);
+	return farray_accessor<const T, R>(farr.cbegin(), farr.LBound(), farr.get_delta());
+}
+
+/****************
+* accessor of a dummy argument, which fortran guarantees not to overlap any other array modified in the procedure
+*	compilers only trust a restricted pointer which is a function parameter
+*	, so the translator passes these accessors by value to a lambda wrapping the loop
+*======================================
+*	[&](auto a_at, auto b_at){
+*		for(...) a_at(i) = b_at(i) * 2;
+*	}(forrank_restrict<1>(a), forrank_restrict<1>(b));
+*======================================
+****************/
+template <int R, typename T>
+farray_accessor<T, R, T * __restrict> forrank_restrict(farray<T> & farr) {
+	assert(farr.dimension == R);
+	return farray_accessor<T, R, T * __restrict>(farr.begin(), farr.LBound(), farr.get_delta());
+}
+template <int R, typename T>
+farray_accessor<const T, R, const T * __restrict> forrank_restrict(const farray<T> & farr) {
+	assert(farr.dimension == R);
+	return farray_accessor<const T, R, const T * __restrict>(farr.cbegin(), farr.LBound(), farr.get_delta());
+}
+
 template <typename T1, typename T2> 
 auto power(const farray<T1> & x, const farray<T2> & y) { 
 	assert(x.flatsize() == y.flatsize()); 
@@ -731,7 +916,7 @@ farray<T> make_init_list(const T(&values)[X]){
 	narr.reset_value(values, values + X);
 	return _RTN(narr);
 }
-template <typename T>
+template <typename T, _NOT_FARRAY(T)>
 farray<T> make_init_list(const T & scalar)  {
 	/***************
 	*	ISO/IEC 1539:1991 1.5.2
@@ -742,7 +927,7 @@ farray<T> make_init_list(const T & scalar)  {
 	farray<T> narr{ scalar };
 	return _RTN(narr);
 }
-template <typename T>
+template <typename T, _NOT_FARRAY(T)>
 farray<T> make_init_list(int repeat, const T & scalar) {
 	farray<T> narr({ 1 }, { repeat });
 	narr.reset_value(scalar);
@@ -756,27 +941,29 @@ farray<T> make_init_list(const farray<T> & narr) {
 }
 
 _NAMESPACE_HIDDEN_BEGIN
-template <typename T, int X, typename _Iterator_In, typename _Iterator_Out>
+template <typename T, int X, bool Back = false, typename _Iterator_In, typename _Iterator_Out>
 void _forslice_impl(const slice_info<fsize_t>(&tp)[X], const farray<T> & farr, int deep, const fsize_t * delta_out, const fsize_t * delta_in
 	, _Iterator_Out bo, _Iterator_Out eo, _Iterator_In bi, _Iterator_In ei)
 {
 	int _X = X;
-	for (fsize_t i = farr.LBound(deep); i < farr.LBound(deep) + farr.size(deep); i++)
+	// the section is `fr, fr + step, ...` up to `to`, so a negative step walks backwards, like `a(5:1:-1)`
+	fsize_t extent = fordo_tripcount(tp[deep].fr, tp[deep].to, tp[deep].step);
+	for (fsize_t j = 0; j < extent; j++)
 	{
-		bool hit = i >= tp[deep].fr && i <= tp[deep].to && ((i - tp[deep].fr) % tp[deep].step) == 0;
-		if (hit) {
-			if (deep + 1 == _X) { // if X not equal to narr.dimension, behaviour is not defined
-				*bo = *bi;
+		_Iterator_Out o = bo + j * delta_out[deep];
+		_Iterator_In i = bi + (tp[deep].fr - farr.LBound(deep) + j * tp[deep].step) * delta_in[deep];
+		if (deep + 1 == _X) { // if X not equal to narr.dimension, behaviour is not defined
+			if constexpr (Back)
+			{
+				// copy the section back, ref `farray_section`
+				*i = *o;
 			}
-			else { 
-				_forslice_impl<T, X>(tp, farr, deep + 1, delta_out, delta_in, bo, bo + delta_out[deep], bi, bi + delta_out[deep]);
+			else {
+				*o = *i;
 			}
 		}
-		if (i != farr.LBound(deep) + farr.size(deep)) {
-			if (hit) {
-				bo += delta_out[deep];
-			}
-			bi += delta_in[deep];
+		else { 
+			_forslice_impl<T, X, Back>(tp, farr, deep + 1, delta_out, delta_in, o, o + delta_out[deep], i, i + delta_in[deep]);
 		}
 	}
 };
@@ -805,13 +992,90 @@ auto forslice(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
 	narr.reset_value();
 	// because `narr` can have fewer dimensions than `farr`, `narr.get_delta()` can't be used here
 	fsize_t ndelta[X];
-	std::transform(ntp, ntp + X, ndelta, [](auto x) {return (x.to + 1 - x.fr) / x.step + ((x.to + 1 - x.fr) % x.step == 0 ? 0 : 1); }); // size
+	std::transform(ntp, ntp + X, ndelta, [](auto x) {return fordo_tripcount(x.fr, x.to, x.step); }); // size
 	fa_layer_delta(ndelta, ndelta + X, ndelta);
 	_forslice_impl<T, X>(ntp, farr, 0, ndelta, farr.get_delta(), narr.begin(), narr.end(), farr.cbegin(), farr.cend());
 
 	return _RTN(narr);
 }
 
+/****************
+* an array section which is an actual argument, ref `forsection`
+*	a section contiguous in the storage of `farr`, like `a(:, j)` or `x(2:n)`, is a view of it.
+*	any other section is copied in, and copied out after the call, as fortran compilers do
+*	, instead of `forslice`, whose copy is lost when the callee modifies it
+****************/
+template <typename T, int X>
+struct farray_section {
+	farray_section(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X], bool writable) {
+		fsize_t offset = 0;
+		int dim = 0;
+		bool contiguous = X == farr.dimension;
+		bool full = true; // whether all previous dimensions are selected as a whole
+		for (int i = 0; i < X; i++)
+		{
+			ntp[i] = tp[i].isall ? slice_info<fsize_t>({ farr.LBound(i), farr.UBound(i) }) : tp[i];
+			fsize_t extent = fordo_tripcount(ntp[i].fr, ntp[i].to, ntp[i].step);
+			if (ntp[i].isslice)
+			{
+				size[dim++] = extent;
+			}
+			if (extent <= 0 || (extent > 1 && (!full || ntp[i].step != 1)))
+			{
+				contiguous = false;
+			}
+			if (extent != farr.size(i))
+			{
+				full = false;
+			}
+			if (i < farr.dimension)
+			{
+				offset += (ntp[i].fr - farr.LBound(i)) * farr.get_delta()[i];
+			}
+		}
+		if (contiguous)
+		{
+			arr.emplace(const_cast<T *>(farr.cbegin()) + offset, dim, lb, size, delta);
+		}
+		else {
+			arr.emplace(forslice(farr, tp));
+			parent = writable ? const_cast<farray<T> *>(&farr) : nullptr;
+		}
+	}
+	farray_section(const farray_section<T, X> &) = delete;
+	~farray_section() {
+		if (parent != nullptr)
+		{
+			fsize_t ndelta[X];
+			std::transform(ntp, ntp + X, ndelta, [](auto x) {return fordo_tripcount(x.fr, x.to, x.step); });
+			fa_layer_delta(ndelta, ndelta + X, ndelta);
+			_forslice_impl<T, X, true>(ntp, *parent, 0, ndelta, parent->get_delta(), arr->begin(), arr->end(), parent->begin(), parent->end());
+		}
+	}
+	operator farray<T> &() {
+		return *arr;
+	}
+	template <typename U, typename = std::enable_if_t<std::is_same<U, farray<T>>::value>>
+	operator U &&() {
+		return std::move(*arr);
+	}
+
+private:
+	slice_info<fsize_t> ntp[X];
+	fsize_t lb[X], size[X], delta[X]; // shape of the view
+	std::optional<farray<T>> arr;
+	farray<T> * parent = nullptr; // where a copied section is written back to
+};
+
+template <typename T, int X>
+farray_section<T, X> forsection(farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
+	return farray_section<T, X>(farr, tp, true);
+}
+template <typename T, int X>
+farray_section<T, X> forsection(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
+	return farray_section<T, X>(farr, tp, false);
+}
+
 template <typename T>
 farray<T> fortranspose(const farray<T> & farr) {
 	farray<T> narr(farr);
@@ -875,7 +1139,7 @@ farray<T> _forloc_impl(F predicate, const farray<T> & farr, int fordim, foroptio
 		}
 		inited.get(subcur.begin(), subcur.end()) = true;
 	});
-	return _RTN(loc);
+	return _RTN(farray<T>(loc));
 }
 template <typename T, typename F>
 farray<T> _forloc_impl(F predicate, const farray<T> & farr, foroptional<mask_wrapper_t> mask = None) {
@@ -891,7 +1155,7 @@ farray<T> _forloc_impl(F predicate, const farray<T> & farr, foroptional<mask_wra
 		}
 		inited = true;
 	});
-	return _RTN(loc);
+	return _RTN(farray<T>(loc));
 }
 _NAMESPACE_HIDDEN_END
 
@@ -901,13 +1165,9 @@ T formap(F f, T x) {
 	return f(x);
 }
 template <typename T, typename F>
-farray<T> formap(F f, const farray<T> & farr) {
-	// `formap`'s specialation for `const farray<T> &`
-	farray<T> narr = farr;
-	narr.map([&](T & current_value, const fsize_t * cur) {
-		f(current_value);
-	});
-	return _RTN(narr);
+auto formap(F f, const farray<T> & farr) {
+	// `formap`'s specialation for `const farray<T> &`, ref `forelemental`
+	return forelemental(f, farr);
 }
 
 template <typename R, typename T, typename F>
@@ -1121,6 +1381,199 @@ auto forminval(const farray<T> & farr, foroptional<int> fordim, foroptional<mask
 	return _forcmpval_impl(std::less<T>(), +forhuge<T>(), farr, fordim, mask);
 }
 
+/****************
+* the elements of a section `farr(tp)` of rank `R`, read in the storage of `farr` without copying the section
+*	`view(k)` is the element at the 0-based position `k` of the section
+*	scalar subscripts of `tp` are folded into the offset, unless `R == X`, where they are dimensions of extent 1
+****************/
+template <typename T, int R>
+struct farray_strided {
+	template <int X>
+	farray_strided(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
+		static_assert(X >= R, "a section has no more dimensions than its subscripts");
+		assert(X <= farr.dimension);
+		base = farr.cbegin();
+		int dim = 0;
+		for (int i = 0; i < X; i++)
+		{
+			slice_info<fsize_t> x = tp[i].isall ? slice_info<fsize_t>({ farr.LBound(i), farr.UBound(i) }) : tp[i];
+			base += (x.fr - farr.LBound(i)) * farr.get_delta()[i];
+			if (x.isslice || R == X)
+			{
+				// `a(n:1:-1)` has `n` elements, `a(2:1)` has none
+				size[dim] = std::max<fsize_t>((x.to - x.fr + x.step) / x.step, 0);
+				stride[dim] = x.step * farr.get_delta()[i];
+				dim++;
+			}
+		}
+		assert(dim == R);
+	}
+	explicit farray_strided(const farray<T> & farr) {
+		// the whole array
+		assert(farr.dimension == R);
+		base = farr.cbegin();
+		std::copy_n(farr.size(), R, size);
+		std::copy_n(farr.get_delta(), R, stride);
+	}
+	const T & operator()(const fsize_t(&k)[R]) const {
+		fsize_t offset = 0;
+		for (int d = 0; d < R; d++)
+		{
+			offset += k[d] * stride[d];
+		}
+		return base[offset];
+	}
+
+	const T * base;
+	fsize_t size[R], stride[R];
+};
+
+template <int R, typename T, int X>
+farray_strided<T, R> forstrided(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
+	return farray_strided<T, R>(farr, tp);
+}
+template <int R, typename T>
+farray_strided<T, R> forstrided(const farray<T> & farr) {
+	return farray_strided<T, R>(farr);
+}
+
+struct fornomask {
+	template <int R>
+	constexpr bool operator()(const fsize_t(&)[R]) const {
+		return true;
+	}
+};
+
+/****************
+* reduces the elements `element(k)` selected by `mask(k)`, for every position `k` of the shape `size`
+*	positions are visited in array element order, the first dimension in the innermost loop
+*	, so an intrinsic over sections and masked expressions is one loop without temporary arrays
+****************/
+template <int R, typename V, typename F, typename E, typename M>
+V forreduce_strided(F binop, V initial, const fsize_t(&size)[R], E element, M mask)
+{
+	for (int d = 0; d < R; d++)
+	{
+		if (size[d] <= 0)
+		{
+			return initial;
+		}
+	}
+	fsize_t k[R] = {};
+	while (true) {
+		for (k[0] = 0; k[0] < size[0]; k[0]++)
+		{
+			if (mask(k))
+			{
+				initial = binop(initial, element(k));
+			}
+		}
+		int d = 1;
+		for (; d < R; d++)
+		{
+			if (++k[d] < size[d])
+			{
+				break;
+			}
+			k[d] = 0;
+		}
+		if (d >= R)
+		{
+			break;
+		}
+	}
+	return initial;
+}
+
+_NAMESPACE_HIDDEN_BEGIN
+template <int R, typename E>
+using _forstrided_value_t = std::decay_t<decltype(std::declval<E>()(std::declval<const fsize_t(&)[R]>()))>;
+_NAMESPACE_HIDDEN_END
+
+template <int R, typename E, typename M = fornomask>
+auto forsum_strided(const fsize_t(&size)[R], E element, M mask = M{}) {
+	typedef _forstrided_value_t<R, E> T;
+	return forreduce_strided([](const T & op1, const T & op2) -> T {
+		return op1 + op2;
+	}, T(0), size, element, mask);
+}
+template <int R, typename E, typename M = fornomask>
+auto forproduct_strided(const fsize_t(&size)[R], E element, M mask = M{}) {
+	typedef _forstrided_value_t<R, E> T;
+	return forreduce_strided([](const T & op1, const T & op2) -> T {
+		return op1 * op2;
+	}, T(1), size, element, mask);
+}
+template <int R, typename E, typename M = fornomask>
+auto formaxval_strided(const fsize_t(&size)[R], E element, M mask = M{}) {
+	typedef _forstrided_value_t<R, E> T;
+	return forreduce_strided([](const T & op1, const T & op2) -> T {
+		return op2 > op1 ? op2 : op1;
+	}, T(-forhuge<T>()), size, element, mask);
+}
+template <int R, typename E, typename M = fornomask>
+auto forminval_strided(const fsize_t(&size)[R], E element, M mask = M{}) {
+	typedef _forstrided_value_t<R, E> T;
+	return forreduce_strided([](const T & op1, const T & op2) -> T {
+		return op2 < op1 ? op2 : op1;
+	}, T(+forhuge<T>()), size, element, mask);
+}
+template <int R, typename E>
+fsize_t forcount_strided(const fsize_t(&size)[R], E element) {
+	return forreduce_strided([](fsize_t op1, bool op2) -> fsize_t {
+		return op2 ? op1 + 1 : op1;
+	}, fsize_t(0), size, element, fornomask{});
+}
+template <int R, typename E>
+bool forany_strided(const fsize_t(&size)[R], E element) {
+	return forreduce_strided([](bool op1, bool op2) -> bool {
+		return op1 || op2;
+	}, false, size, element, fornomask{});
+}
+template <int R, typename E>
+bool forall_strided(const fsize_t(&size)[R], E element) {
+	return forreduce_strided([](bool op1, bool op2) -> bool {
+		return op1 && op2;
+	}, true, size, element, fornomask{});
+}
+
+// reductions of a section `farr(tp)`, which is not copied, ref `forslice`
+template <typename T, int X>
+auto forsum(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
+	const farray_strided<T, X> view(farr, tp);
+	return forsum_strided(view.size, view);
+}
+template <typename T, int X>
+auto forproduct(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
+	const farray_strided<T, X> view(farr, tp);
+	return forproduct_strided(view.size, view);
+}
+template <typename T, int X>
+auto formaxval(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
+	const farray_strided<T, X> view(farr, tp);
+	return formaxval_strided(view.size, view);
+}
+template <typename T, int X>
+auto forminval(const farray<T> & farr, const slice_info<fsize_t>(&tp)[X]) {
+	const farray_strided<T, X> view(farr, tp);
+	return forminval_strided(view.size, view);
+}
+template <int X>
+fsize_t forcount(const farray<bool> & mask, const slice_info<fsize_t>(&tp)[X]) {
+	const farray_strided<bool, X> view(mask, tp);
+	return forcount_strided(view.size, view);
+}
+template <int X>
+bool forany(const farray<bool> & mask, const slice_info<fsize_t>(&tp)[X]) {
+	const farray_strided<bool, X> view(mask, tp);
+	return forany_strided(view.size, view);
+}
+template <int X>
+bool forall(const farray<bool> & mask, const slice_info<fsize_t>(&tp)[X]) {
+	const farray_strided<bool, X> view(mask, tp);
+	return forall_strided(view.size, view);
+}
+
 template <typename T1, typename T2>
 auto formerge(const farray<T1> & tarr, const farray<T2> & farr, const farray<bool> & mask) {
 	/*****************
@@ -1143,5 +1596,59 @@ auto formerge(const farray<T1> & tarr, const farray<T2> & farr, const farray<boo
 	}
 	return _RTN(narr);
 }
+
+// the `k`th element in memory order of an array, a scalar is the same for every `k`
+// used by `where` constructs which can't be scalarized
+template <typename T>
+const T & forelement(const farray<T> & farr, fsize_t k) {
+	return farr.cbegin()[k];
+}
+template <typename T, _NOT_FARRAY(T)>
+const T & forelement(const T & x, fsize_t k) {
+	return x;
+}
+
+// the first array of the arguments of an elemental call, which gives the shape of the result
+template <typename X, typename... Args>
+decltype(auto) _forelemental_shape(const X & x, const Args & ... args) {
+	if constexpr (is_farray<X>::value) {
+		return (x);
+	}
+	else {
+		return _forelemental_shape(args...);
+	}
+}
+template <typename... Args>
+struct forany_farray : std::disjunction<is_farray<Args>...> {};
+
+// elemental function `f` applied to arrays and scalars `args`, which conform
+// the result is written in one loop, without copying any argument
+template <typename F, typename... Args>
+auto forelemental(F f, const Args & ... args) {
+	typedef std::decay_t<decltype(f(forelement(args, 0)...))> R;
+	const auto & shape = _forelemental_shape(args...);
+	farray<R> narr(shape.dimension, shape.LBound(), shape.size());
+	R * narr_flat = narr.begin();
+	for (fsize_t k = 0; k < narr.flatsize(); k++)
+	{
+		narr_flat[k] = f(forelement(args, k)...);
+	}
+	return _RTN(narr);
+}
+// overloads elemental function `F` for array arguments, ref `gen_program`
+#define FOR_ELEMENTAL(F) template <typename... Args, typename = std::enable_if_t<forany_farray<Args...>::value>> \
+	inline auto F(const Args & ... args) { return forelemental([](const auto & ... x) { return F(x...); }, args...); }
+
+// a `where` mask of the same shape as `farr`, element `k` is `f(k)`
+template <typename T, typename F>
+farray<bool> forwhere_mask(const farray<T> & farr, F f) {
+	farray<bool> narr(farr.dimension, farr.LBound(), farr.size());
+	auto narr_iter = narr.begin();
+	for (fsize_t k = 0; k < narr.flatsize(); k++, narr_iter++)
+	{
+		*narr_iter = f(k);
+	}
+	return _RTN(narr);
+}
 _NAMESPACE_FORTRAN_END
 
@@ -0,0 +1,139 @@
+/*
+*   Calvin Neo
+*   Copyright (C) 2016  Calvin Neo <calvinneo@calvinneo.com>
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License along
+*   with this program; if not, write to the Free Software Foundation, Inc.,
+*   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#pragma once
+#include "farray.h"
+#include <cstddef>
+#include <memory>
+
+#ifndef FOR_ARENA_CAPACITY
+#define FOR_ARENA_CAPACITY (1 << 22)
+#endif
+#ifndef FOR_ARENA_MAX_SIZE
+#define FOR_ARENA_MAX_SIZE (1 << 16)
+#endif
+
+_NAMESPACE_FORTRAN_BEGIN
+/****************
+* a stack of storage of each thread, for the elements of `fautoarray`s
+*	local variables are destructed in the reverse order of their construction
+*	, so the storage is released by moving the top of the stack back
+*	an array larger than `FOR_ARENA_MAX_SIZE` bytes, or which doesn't fit in `FOR_ARENA_CAPACITY` bytes
+*	, is allocated on the heap
+****************/
+struct farena {
+	static constexpr std::size_t capacity = FOR_ARENA_CAPACITY;
+	static constexpr std::size_t max_size = FOR_ARENA_MAX_SIZE;
+	static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+	static farena & get() {
+		static thread_local farena arena;
+		return arena;
+	}
+	void * allocate(std::size_t bytes) {
+		bytes = (bytes + alignment - 1) / alignment * alignment;
+		if (bytes > max_size || bytes > capacity - top)
+		{
+			return nullptr;
+		}
+		if (base == nullptr)
+		{
+			// the storage is allocated when the thread first needs it
+			base = static_cast<char *>(::operator new(capacity));
+		}
+		void * p = base + top;
+		top += bytes;
+		return p;
+	}
+	void release(void * p) {
+		assert(static_cast<char *>(p) >= base && static_cast<char *>(p) <= base + top);
+		top = static_cast<char *>(p) - base;
+	}
+	~farena() {
+		::operator delete(base);
+	}
+
+private:
+	char * base = nullptr;
+	std::size_t top = 0;
+};
+
+/****************
+* an automatic array of rank `R`, like `real work(n, m)` whose bounds are decided when the subprogram is called
+*	the bounds are stored inside the object, and the elements in the `farena` of the thread
+*	, so a call doesn't allocate on the heap
+*	it is a `farray<T>`, so it can be passed wherever `farray<T>` is accepted
+****************/
+template <typename T, int R>
+struct fautoarray : public farray<T> {
+	fautoarray(const fsize_t(&lower_bound)[R], const fsize_t(&size)[R]) noexcept {
+		bind(lower_bound, size);
+		std::uninitialized_value_construct_n(this->parr, this->flatsize());
+	}
+	fautoarray() noexcept {
+		// an array without elements, like a default constructed `farray`
+		// an OpenMP `private` copy would be one, so arrays in `private` are made `firstprivate`, ref `map_private_arrays`
+		const fsize_t lower_bound[R]{}, size[R]{};
+		bind(lower_bound, size);
+	}
+	fautoarray(const fautoarray & m) noexcept {
+		bind(m.lb_storage, m.sz_storage);
+		std::uninitialized_copy_n(m.parr, this->flatsize(), this->parr);
+	}
+	fautoarray & operator=(const fautoarray & x) {
+		std::copy_n(x.parr, this->flatsize(), this->parr);
+		return *this;
+	}
+	using farray<T>::operator=;
+	~fautoarray() {
+		std::destroy_n(this->parr, this->flatsize());
+		if (in_arena)
+		{
+			farena::get().release(this->parr);
+		}
+		else {
+			::operator delete(this->parr);
+		}
+	}
+
+private:
+	void bind(const fsize_t(&lower_bound)[R], const fsize_t(&size)[R]) {
+		std::copy_n(lower_bound, R, lb_storage);
+		for (int i = 0; i < R; i++)
+		{
+			// an array of negative extent has no element
+			sz_storage[i] = std::max<fsize_t>(size[i], 0);
+		}
+		fa_layer_delta(sz_storage, sz_storage + R, delta_storage);
+		this->dimension = R;
+		this->lb = lb_storage;
+		this->sz = sz_storage;
+		this->delta = delta_storage;
+		this->fixed = true;
+		std::size_t bytes = this->flatsize() * sizeof(T);
+		void * p = farena::get().allocate(bytes);
+		in_arena = p != nullptr;
+		this->parr = static_cast<T *>(in_arena ? p : ::operator new(bytes));
+	}
+
+	bool in_arena;
+	fsize_t lb_storage[R], sz_storage[R], delta_storage[R];
+};
+_NAMESPACE_FORTRAN_END
@@ -24,7 +24,11 @@
 #include "forstdio.h"
 #include "forfilesys.h"
 #include "farray.h"
+#include "fstaticarray.h"
+#include "fautoarray.h"
 #include "forstring.h"
+#include "forparallel.h"
+#include "forprofile.h"
 
 
 #define USE_FORARRAY
@@ -26,12 +26,37 @@
 #include <array>
 #include <random>
 #include <tuple>
+#include <stdexcept>
 #include "forlang.h"
 #include "utils.h"
 
 #define USE_FORARRAY
 _NAMESPACE_FORTRAN_BEGIN
+/***************
+* type of array extents, bounds, strides and flat indexes
+* 64-bit, so an array can have more than 2^31 elements. define `FORARRAY_INDEX32` to use `int`
+***************/
+#ifdef FORARRAY_INDEX32
 typedef int fsize_t;
+#else
+typedef long long fsize_t;
+#endif
+
+// product of array extents, which must not overflow `fsize_t`, or the array can't be allocated
+inline fsize_t fa_checked_mul(fsize_t x, fsize_t y) {
+	if (x > 0 && y > 0 && x > std::numeric_limits<fsize_t>::max() / y)
+	{
+		throw std::length_error("array size overflows fsize_t");
+	}
+	return x * y;
+}
+
+// iteration count of `do i = from, to, step`, evaluated once before the loop(8.1.4.4.1)
+template<typename T1, typename T2, typename T3>
+inline fsize_t fordo_tripcount(const T1 & from, const T2 & to, const T3 & step) {
+	fsize_t trip = (fsize_t)((to - from + step) / step);
+	return trip > 0 ? trip : 0;
+}
 
 template<typename T>
 struct slice_info {
@@ -48,23 +73,25 @@ struct slice_info {
 		// a single element, not slice
 		fr = i; to = i; step = 1;
 		isslice = false;
+		isall = false;
 	}
 	slice_info(std::initializer_list<T> il) {
-		std::vector<T> l(il);
-		if (l.size() == 1)
+		// not copied into a `std::vector`, slices are made in every call with an array section
+		const T * l = il.begin();
+		if (il.size() == 1)
 		{
 			// a single element, not slice. squash this dimension
 			fr = l[0]; step = 1; to = l[0];
 			isslice = false;
 			isall = false;
 		}
-		else if (l.size() == 2) {
+		else if (il.size() == 2) {
 			// [from, to]
 			fr = l[0]; step = 1; to = l[1];
 			isslice = true;
 			isall = false;
 		}
-		else if (l.size() == 0) {
+		else if (il.size() == 0) {
 			// select all
 			isslice = true;
 			isall = true;
@@ -73,6 +100,7 @@ struct slice_info {
 			// [from, to] step
 			fr = l[0]; step = l[2]; to = l[1];
 			isslice = true;
+			isall = false;
 		}
 	}
 	slice_info(const slice_info<T> & x) : fr(x.fr), to(x.to), step(x.step), isall(x.isall), isslice(x.isslice) {
@@ -85,20 +113,21 @@ std::vector<fsize_t> fa_layer_delta(Iterator size_begin, Iterator size_end) {
 	std::vector<fsize_t> next_iter_delta(size_begin, size_end);
 	fsize_t s = 1;
 	std::transform(next_iter_delta.begin(), next_iter_delta.end(), next_iter_delta.begin()
-		, [&s](fsize_t x) {fsize_t ans = s; s *= x; return ans; });
+		, [&s](fsize_t x) {fsize_t ans = s; s = fa_checked_mul(s, x); return ans; });
 	return next_iter_delta;
 }	
 template<typename In_Iter, typename Out_Iter>
 void fa_layer_delta(In_Iter size_begin, In_Iter size_end, Out_Iter out_begin) {
 	fsize_t s = 1;
 	// TODO use partial_sum or exclusive_scan/inclusive_scan
-	std::transform(size_begin, size_end, out_begin, [&s](fsize_t x) {fsize_t ans = s; s *= x; return ans; });
+	// `s` is the flatsize at last, so it is checked here, ref `farray::flatsize`
+	std::transform(size_begin, size_end, out_begin, [&s](fsize_t x) {fsize_t ans = s; s = fa_checked_mul(s, x); return ans; });
 }
 #else
 #endif
 template<typename _Iterator>
 fsize_t fa_getflatsize(_Iterator b, _Iterator e) {
-	fsize_t sizeflat = std::accumulate(b, e, 1, [](auto x, auto y) {return x * y; });
+	fsize_t sizeflat = std::accumulate(b, e, (fsize_t)1, [](fsize_t x, fsize_t y) {return fa_checked_mul(x, y); });
 	return sizeflat;
 }
 _NAMESPACE_FORTRAN_END
\ No newline at end of file
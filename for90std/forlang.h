@@ -29,6 +29,37 @@
 #include "fordefs.h"
 
 _NAMESPACE_FORTRAN_BEGIN
+/****************
+* an actual argument which is a variable, ref `forarg`
+*	it binds to `T &` of `intent(out)`/`intent(inout)`, to `const T &` and `T` of `intent(in)`
+*	, and to `T &&` of a dummy argument without intent, all without a copy
+****************/
+template <typename T>
+struct forarg_ref {
+	T & x;
+	operator T &() const {
+		return x;
+	}
+	// a template is less preferred than `operator T &`, so it is only chosen for `T &&`
+	//	, or `U &&` of a base `U`, e.g. `farray<T>` of `fstaticarray`
+	template <typename U, typename = std::enable_if_t<std::is_base_of<U, T>::value || std::is_same<U, T>::value>>
+	operator U &&() const {
+		return static_cast<U &&>(x);
+	}
+};
+template <typename T>
+decltype(auto) forarg(T && x) {
+	// `INOUT(X)`. expressions, constants and string literals are moved as before
+	typedef std::remove_reference_t<T> V;
+	if constexpr (std::is_lvalue_reference<T>::value && !std::is_const<V>::value && !std::is_array<V>::value && !std::is_function<V>::value)
+	{
+		return forarg_ref<V>{ x };
+	}
+	else {
+		return std::move(x);
+	}
+}
+
 struct foroptional_dummy {};
 extern const foroptional_dummy None;
 template <typename T>
@@ -65,6 +96,10 @@ struct foroptional
 		delete value_ptr;
 		value_ptr = new T(newv);
 	}
+	template <typename U>
+	foroptional(const forarg_ref<U> & newv) : foroptional((const U &)newv.x) {
+		// `INOUT(X)` passed to an optional dummy argument
+	}
 	foroptional(const foroptional<T> & newv) {
 		// copy constructor
 		if (newv.inited())
@@ -146,6 +181,10 @@ template<typename T>
 double to_double(T x, foroptional<int> kind = None) {
 	return (double)x;
 }
+template<typename T>
+float to_float(T x, foroptional<int> kind = None) {
+	return (float)x;
+}
 // type cast from string
 inline int to_int(std::string x, foroptional<int> kind = None) {
 	int a;
@@ -167,6 +206,11 @@ inline double to_double(std::string x, foroptional<int> kind = None) {
 	sscanf(x.c_str(), "%lf", &a);
 	return a;
 }
+inline float to_float(std::string x, foroptional<int> kind = None) {
+	float a;
+	sscanf(x.c_str(), "%f", &a);
+	return a;
+}
 inline bool to_bool(std::string x) {
 	std::transform(x.begin(), x.end(), x.begin(), [](const char ch) {return std::tolower(ch); });
 	return !x.empty() && (std::strcmp(x.c_str(), "true") == 0 || std::atoi(x.c_str()) != 0);
@@ -46,7 +46,7 @@ decltype(std::declval<T1>() + std::declval<T2>()) max_n(T1 x, T2 y) {
 
 typedef std::complex<double> forcomplex;
 
-template<class T1, class T2>
+template<class T1, class T2, _NOT_FARRAY(T1), _NOT_FARRAY(T2)>
 auto power(T1 x, T2 y) {
 	return powl(x, y);
 }
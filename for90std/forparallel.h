@@ -0,0 +1,308 @@
+/*
+*   Calvin Neo
+*   Copyright (C) 2016  Calvin Neo <calvinneo@calvinneo.com>
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License along
+*   with this program; if not, write to the Free Software Foundation, Inc.,
+*   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstdlib>
+#include "forarray_common.h"
+
+_NAMESPACE_FORTRAN_BEGIN
+/****************
+* a persistent pool running `do concurrent`, `forall` and DO loops parallelized by the translator
+*	the calling thread works too, so `size()` threads run a loop
+*	loops issued inside a running loop execute serially on the issuing thread
+*	the number of threads is read from FOR90STD_NUM_THREADS, or the hardware
+****************/
+struct forthread_pool {
+	typedef std::function<void(fsize_t, fsize_t)> task_type;
+
+	explicit forthread_pool(unsigned nthreads) {
+		for (unsigned i = 1; i < nthreads; i++)
+		{
+			workers.emplace_back([this]() { worker_loop(); });
+		}
+	}
+	~forthread_pool() {
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			stopping = true;
+		}
+		cv_work.notify_all();
+		for (std::thread & t : workers)
+		{
+			t.join();
+		}
+	}
+	forthread_pool(const forthread_pool &) = delete;
+	forthread_pool & operator=(const forthread_pool &) = delete;
+
+	unsigned size() const { return (unsigned)workers.size() + 1; }
+
+	// run `task(b, e)` over disjoint chunks covering [0, n), returns when all chunks are done
+	void parallel_for(fsize_t n, const task_type & task) {
+		if (n <= 0)
+		{
+			return;
+		}
+		if (workers.empty() || n == 1 || in_loop())
+		{
+			task(0, n);
+			return;
+		}
+		std::lock_guard<std::mutex> run_lk(run_mtx);
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			job = &task;
+			job_size = n;
+			// several chunks per thread, so uneven iterations still balance
+			job_chunk = std::max<fsize_t>(1, n / (fsize_t)(4 * size()));
+			next_chunk.store(0);
+			busy = (unsigned)workers.size();
+			generation++;
+		}
+		cv_work.notify_all();
+		run_chunks(task, n, job_chunk);
+		std::unique_lock<std::mutex> lk(mtx);
+		cv_done.wait(lk, [this]() { return busy == 0; });
+		job = nullptr;
+	}
+
+private:
+	static bool & in_loop() {
+		static thread_local bool flag = false;
+		return flag;
+	}
+	void run_chunks(const task_type & task, fsize_t n, fsize_t chunk) {
+		in_loop() = true;
+		for (fsize_t b = next_chunk.fetch_add(chunk); b < n; b = next_chunk.fetch_add(chunk))
+		{
+			task(b, std::min(b + chunk, n));
+		}
+		in_loop() = false;
+	}
+	void worker_loop() {
+		unsigned seen = 0;
+		while (true) {
+			const task_type * task;
+			fsize_t n, chunk;
+			{
+				std::unique_lock<std::mutex> lk(mtx);
+				cv_work.wait(lk, [&]() { return stopping || generation != seen; });
+				if (stopping)
+				{
+					return;
+				}
+				seen = generation;
+				task = job; n = job_size; chunk = job_chunk;
+			}
+			run_chunks(*task, n, chunk);
+			{
+				std::lock_guard<std::mutex> lk(mtx);
+				busy--;
+			}
+			cv_done.notify_one();
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::mutex run_mtx; // one loop at a time
+	std::mutex mtx;
+	std::condition_variable cv_work, cv_done;
+	const task_type * job = nullptr;
+	fsize_t job_size = 0, job_chunk = 1;
+	std::atomic<fsize_t> next_chunk{ 0 };
+	unsigned generation = 0;
+	unsigned busy = 0;
+	bool stopping = false;
+};
+
+inline forthread_pool & get_forpool() {
+	// never destructed, a `stop` inside a loop body must not wait for the other threads
+	static forthread_pool * pool = []() {
+		unsigned n = std::thread::hardware_concurrency();
+		const char * env = std::getenv("FOR90STD_NUM_THREADS");
+		if (env != nullptr && std::atoi(env) > 0)
+		{
+			n = (unsigned)std::atoi(env);
+		}
+		return new forthread_pool(n > 0 ? n : 1);
+	}();
+	return *pool;
+}
+
+template<std::size_t D, typename F, std::size_t... I>
+inline decltype(auto) forconcurrent_call(F & f, const fsize_t(&index)[D], std::index_sequence<I...>) {
+	return f(index[I]...);
+}
+
+template<std::size_t D, typename F, typename T, std::size_t... I>
+inline void forconcurrent_call_value(F & f, T & value, const fsize_t(&index)[D], std::index_sequence<I...>) {
+	f(value, index[I]...);
+}
+
+template<std::size_t D, typename G>
+inline void forconcurrent_chunk(const fsize_t(&from)[D], const fsize_t(&step)[D], const fsize_t(&trip)[D], fsize_t b, fsize_t e, G & g) {
+	// calls `g(k, index)` for flat positions [b, e), the first index varies fastest, which is the memory order of farray
+	fsize_t index[D];
+	fsize_t rest = b;
+	for (std::size_t d = 0; d < D; d++)
+	{
+		index[d] = from[d] + (rest % trip[d]) * step[d];
+		rest /= trip[d];
+	}
+	for (fsize_t k = b; k < e; k++)
+	{
+		g(k, (const fsize_t(&)[D])index);
+		for (std::size_t d = 0; d < D; d++)
+		{
+			index[d] += step[d];
+			if (index[d] != from[d] + trip[d] * step[d])
+			{
+				break;
+			}
+			index[d] = from[d];
+		}
+	}
+}
+
+template<std::size_t D>
+inline fsize_t forconcurrent_trip(const fsize_t(&from)[D], const fsize_t(&to)[D], const fsize_t(&step)[D], fsize_t(&trip)[D]) {
+	fsize_t total = 1;
+	for (std::size_t d = 0; d < D; d++)
+	{
+		trip[d] = fordo_tripcount(from[d], to[d], step[d]);
+		total *= trip[d];
+	}
+	return total;
+}
+
+template<std::size_t D, typename F>
+inline void forconcurrent_flat(const fsize_t(&from)[D], const fsize_t(&to)[D], const fsize_t(&step)[D], F f) {
+	// calls `f(k, index)` for every point of the iteration space, k is the flat position
+	fsize_t trip[D];
+	fsize_t total = forconcurrent_trip(from, to, step, trip);
+	get_forpool().parallel_for(total, [&](fsize_t b, fsize_t e) {
+		// each chunk has its own copy of `f`, so values captured by copy are private to the chunk
+		F chunk_f = f;
+		forconcurrent_chunk(from, step, trip, b, e, chunk_f);
+	});
+}
+
+// `do concurrent (i = f1:t1:s1, j = f2:t2:s2)`, calls `f(i, j)` on each iteration in any order
+template<std::size_t D, typename F>
+inline void forconcurrent(const fsize_t(&from)[D], const fsize_t(&to)[D], const fsize_t(&step)[D], F f) {
+	forconcurrent_flat(from, to, step, [f](fsize_t k, const fsize_t(&index)[D]) mutable {
+		forconcurrent_call(f, index, std::make_index_sequence<D>());
+	});
+}
+
+/****************
+* reduction operators of `forconcurrent_reduce`
+*	each chunk accumulates from `identity(result)` into its own copy
+*	, which are combined into `result` at the end
+****************/
+struct forreduce_add {
+	template<typename T> T identity(const T &) const { return T(0); }
+	template<typename T> T operator()(const T & x, const T & y) const { return x + y; }
+};
+struct forreduce_mul {
+	template<typename T> T identity(const T &) const { return T(1); }
+	template<typename T> T operator()(const T & x, const T & y) const { return x * y; }
+};
+struct forreduce_max {
+	template<typename T> T identity(const T & init) const { return init; }
+	template<typename T> T operator()(const T & x, const T & y) const { return x < y ? y : x; }
+};
+struct forreduce_min {
+	template<typename T> T identity(const T & init) const { return init; }
+	template<typename T> T operator()(const T & x, const T & y) const { return y < x ? y : x; }
+};
+
+// a DO loop accumulating into `result`, calls `f(acc, i)` on each iteration in any order
+template<std::size_t D, typename T, typename Op, typename F>
+inline void forconcurrent_reduce(const fsize_t(&from)[D], const fsize_t(&to)[D], const fsize_t(&step)[D], T & result, Op op, F f) {
+	fsize_t trip[D];
+	fsize_t total = forconcurrent_trip(from, to, step, trip);
+	const T identity = op.identity(result);
+	std::mutex result_mtx;
+	get_forpool().parallel_for(total, [&](fsize_t b, fsize_t e) {
+		F chunk_f = f;
+		T acc = identity;
+		auto g = [&](fsize_t k, const fsize_t(&index)[D]) {
+			forconcurrent_call_value(chunk_f, acc, index, std::make_index_sequence<D>());
+		};
+		forconcurrent_chunk(from, step, trip, b, e, g);
+		std::lock_guard<std::mutex> lk(result_mtx);
+		result = op(result, acc);
+	});
+}
+
+/****************
+* a `forall` assignment whose right side or mask reads the assigned array
+*	every mask and value is evaluated before any element is assigned(7.5.4.4)
+*	`assign(value, i, j)` stores one value
+****************/
+template<std::size_t D, typename Mask, typename Value, typename Assign>
+inline void forall_assign(const fsize_t(&from)[D], const fsize_t(&to)[D], const fsize_t(&step)[D], Mask mask, Value value, Assign assign) {
+	typedef std::decay_t<decltype(forconcurrent_call(value, std::declval<const fsize_t(&)[D]>(), std::make_index_sequence<D>()))> value_type;
+	fsize_t trip[D];
+	std::vector<value_type> values(forconcurrent_trip(from, to, step, trip));
+	std::vector<char> selected(values.size());
+	forconcurrent_flat(from, to, step, [&](fsize_t k, const fsize_t(&index)[D]) {
+		selected[k] = (bool)forconcurrent_call(mask, index, std::make_index_sequence<D>());
+		if (selected[k])
+		{
+			values[k] = forconcurrent_call(value, index, std::make_index_sequence<D>());
+		}
+	});
+	forconcurrent_flat(from, to, step, [&](fsize_t k, const fsize_t(&index)[D]) {
+		if (selected[k])
+		{
+			forconcurrent_call_value(assign, values[k], index, std::make_index_sequence<D>());
+		}
+	});
+}
+
+/****************
+* a `forall` or `where` nested in a `forall`
+*	the mask is evaluated for all indexes before the nested construct runs for any of them
+*	, then `body(i, j)` runs for the selected indexes one after another
+****************/
+template<std::size_t D, typename Mask, typename Body>
+inline void forall_nested(const fsize_t(&from)[D], const fsize_t(&to)[D], const fsize_t(&step)[D], Mask mask, Body body) {
+	fsize_t trip[D];
+	std::vector<char> selected(forconcurrent_trip(from, to, step, trip));
+	forconcurrent_flat(from, to, step, [&](fsize_t k, const fsize_t(&index)[D]) {
+		selected[k] = (bool)forconcurrent_call(mask, index, std::make_index_sequence<D>());
+	});
+	auto g = [&](fsize_t k, const fsize_t(&index)[D]) {
+		if (selected[k])
+		{
+			forconcurrent_call(body, index, std::make_index_sequence<D>());
+		}
+	};
+	forconcurrent_chunk(from, step, trip, 0, (fsize_t)selected.size(), g);
+}
+_NAMESPACE_FORTRAN_END
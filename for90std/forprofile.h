@@ -0,0 +1,171 @@
+/*
+*   Calvin Neo
+*   Copyright (C) 2016  Calvin Neo <calvinneo@calvinneo.com>
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License along
+*   with this program; if not, write to the Free Software Foundation, Inc.,
+*   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include "fordefs.h"
+
+_NAMESPACE_FORTRAN_BEGIN
+struct forprofile_counter {
+	std::uint64_t calls = 0;
+	std::uint64_t inclusive = 0; // nanoseconds, a recursive procedure is counted once for its outermost call
+	std::uint64_t exclusive = 0; // nanoseconds, not including the procedures it calls
+	int active = 0; // count of calls running on the thread
+};
+
+struct forprofile_scope;
+struct forprofile_thread {
+	std::vector<forprofile_counter> counters; // indexed by `forprofile_site::id`
+	forprofile_scope * top = nullptr; // the innermost running call
+
+	forprofile_counter & counter(int id) {
+		if (id >= (int)counters.size())
+		{
+			counters.resize(id + 1);
+		}
+		return counters[id];
+	}
+};
+
+/****************
+* the profile of procedures translated with `--instrument`, which is printed when the program exits
+*	every thread counts in its own `forprofile_thread`, so a call takes no lock
+*	, a lock is only taken when a procedure is called the first time, or a thread calls its first procedure
+* the profile is printed to stderr, or to the file named by FOR90STD_PROFILE
+****************/
+struct forprofile_registry {
+	static forprofile_registry & get() {
+		static forprofile_registry registry;
+		return registry;
+	}
+	int add_site(const char * name) {
+		std::lock_guard<std::mutex> lk(mtx);
+		names.push_back(name);
+		return (int)names.size() - 1;
+	}
+	forprofile_thread & thread() {
+		// counters are owned by the registry, so they outlive the thread and are printed at exit
+		static thread_local forprofile_thread * current = nullptr;
+		if (current == nullptr)
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			threads.emplace_back(new forprofile_thread());
+			current = threads.back().get();
+		}
+		return *current;
+	}
+	void print(FILE * f) {
+		std::lock_guard<std::mutex> lk(mtx);
+		// sum up all threads, and all sites of the same procedure
+		std::map<std::string, forprofile_counter> total;
+		for (const std::unique_ptr<forprofile_thread> & t : threads)
+		{
+			for (size_t id = 0; id < t->counters.size(); id++)
+			{
+				forprofile_counter & x = total[names[id]];
+				x.calls += t->counters[id].calls;
+				x.inclusive += t->counters[id].inclusive;
+				x.exclusive += t->counters[id].exclusive;
+			}
+		}
+		std::vector<std::pair<std::string, forprofile_counter>> rows(total.begin(), total.end());
+		std::stable_sort(rows.begin(), rows.end(), [](const auto & x, const auto & y) {
+			return x.second.exclusive > y.second.exclusive;
+		});
+		fprintf(f, "%-32s %12s %16s %16s\n", "procedure", "calls", "inclusive(s)", "exclusive(s)");
+		for (const std::pair<std::string, forprofile_counter> & row : rows)
+		{
+			fprintf(f, "%-32s %12llu %16.6f %16.6f\n", row.first.c_str(), (unsigned long long)row.second.calls
+				, row.second.inclusive * 1e-9, row.second.exclusive * 1e-9);
+		}
+	}
+	~forprofile_registry() {
+		const char * env = std::getenv("FOR90STD_PROFILE");
+		FILE * f = (env != nullptr && env[0] != '\0') ? fopen(env, "w") : nullptr;
+		print(f == nullptr ? stderr : f);
+		if (f != nullptr)
+		{
+			fclose(f);
+		}
+	}
+
+private:
+	forprofile_registry() = default;
+	std::mutex mtx;
+	std::vector<std::string> names;
+	std::vector<std::unique_ptr<forprofile_thread>> threads;
+};
+
+struct forprofile_site {
+	explicit forprofile_site(const char * name) : id(forprofile_registry::get().add_site(name)) {
+	}
+	const int id;
+};
+
+/****************
+* times a call of a procedure from its construction to its destruction
+*	time of the calls it makes is counted in their `forprofile_scope`s, and subtracted from its exclusive time
+****************/
+struct forprofile_scope {
+	explicit forprofile_scope(const forprofile_site & site) : thread(forprofile_registry::get().thread()), id(site.id), parent(thread.top) {
+		thread.counter(id).active++;
+		thread.top = this;
+		start = now();
+	}
+	~forprofile_scope() {
+		std::uint64_t elapsed = now() - start;
+		forprofile_counter & counter = thread.counter(id);
+		counter.calls++;
+		counter.exclusive += elapsed - children;
+		if (--counter.active == 0)
+		{
+			counter.inclusive += elapsed;
+		}
+		if (parent != nullptr)
+		{
+			parent->children += elapsed;
+		}
+		thread.top = parent;
+	}
+	forprofile_scope(const forprofile_scope &) = delete;
+	forprofile_scope & operator=(const forprofile_scope &) = delete;
+
+private:
+	static std::uint64_t now() {
+		return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	forprofile_thread & thread;
+	int id;
+	forprofile_scope * parent;
+	std::uint64_t start;
+	std::uint64_t children = 0;
+};
+_NAMESPACE_FORTRAN_END
+
+// the first stmt of a procedure translated with `--instrument`
+#define FOR_PROFILE(NAME) static const for90std::forprofile_site _for_profile_site{ NAME }; for90std::forprofile_scope _for_profile_scope{ _for_profile_site }
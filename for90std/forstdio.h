@@ -21,10 +21,12 @@
 #include "farray.h"
 #include <iostream>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <fstream>
 #include <complex>
 #include <cctype>
+#include <utility>
 
 // If forced reversion occurs, FORTRAN 77 advances to the next record and rescans the format, starting with the right-most left parenthesis, including any repeat-count indicators. It then re-uses this part of the format. If there are no inner parenthesis in the FORMAT statement, then the entire format is reused.
 // 若编辑符表中含有重复使用的编辑符组，如2(2X,F3)，则当所有编辑符用完之后，返回至最右边的左括号开始，如果没有左括号，则使用全部
@@ -112,7 +114,9 @@ struct ImpliedDo {
 		_map_impl_next(newf, cur, dim, cur_dim, lb, sz);
 		return cps_retrieve();
 	}
-	bool get_next(T & x){
+	template <typename U>
+	bool get_next(U & x){
+		// `U` may differ from `T`, e.g. `int` from an index expression of `fsize_t`
 		auto newf = [&](fsize_t * _) {
 			// move from expiring value to `ans`
 			//ans = std::move(f(_));
@@ -251,14 +255,17 @@ struct IOFormat {
 		assert(st >= size() || fmt[st] == '%'); // start with an editing
 		size_t e = fmt.find_first_of('%', st + 1); // find next editing
 		if (e == std::string::npos) {
-			// st is the last editing
+			// st is the last editing, which ends the record once
+			editing = fmt.substr(st, size() - st);
+			if (editing.empty() || editing.back() != '\n')
+			{
+				editing += "\n";
+			}
 			if (reversion_end == (int)fmt.size())
 			{
-				editing = fmt.substr(st, size() - st) + "\n";
 				index() = size();
 			}
 			else {
-				editing = fmt.substr(st, size() - st) + "\n";
 				index() = reversion_end;
 			}
 		}
@@ -310,6 +317,19 @@ void _str_fprintf(FILE * f, const std::string & _format, const T & x) {
 inline void _str_fprintf(FILE * f, const std::string & _format, const std::string & x) {
 	fprintf(f, _format.c_str(), x.c_str());
 }
+inline std::string _length_editing(const std::string & editing, const char * conversions, const char * length_modifier) {
+	// the translator generates `%10.4f` for every real and `%5d` for every integer
+	// add `l` for `double`, `L` for `long double` and `ll` for `long long`
+	size_t conv = editing.find_first_not_of("0123456789.-+ #", 1);
+	if (editing.empty() || editing[0] != '%' || conv == std::string::npos || std::strchr(conversions, editing[conv]) == nullptr)
+	{
+		return editing;
+	}
+	return editing.substr(0, conv) + length_modifier + editing.substr(conv);
+}
+inline std::string _real_editing(const std::string & editing, const char * length_modifier) {
+	return _length_editing(editing, "fFeEgG", length_modifier);
+}
 _NAMESPACE_HIDDEN_END
 
 // format
@@ -327,6 +347,18 @@ inline void _forwrite_one(FILE * f, IOFormat & format, const std::string & x) {
 	std::string ed = format.next_editing();
 	fprintf(f, ed.c_str(), x.c_str());
 };
+inline void _forwrite_one(FILE * f, IOFormat & format, const long long & x) {
+	// e.g. `fsize_t` from `forsize`
+	_forwrite_noargs(f, format);
+	std::string ed = _length_editing(format.next_editing(), "di", "ll");
+	fprintf(f, ed.c_str(), x);
+};
+inline void _forwrite_one(FILE * f, IOFormat & format, const long double & x) {
+	// strip front
+	_forwrite_noargs(f, format);
+	std::string ed = _real_editing(format.next_editing(), "L");
+	fprintf(f, ed.c_str(), x);
+};
 
 template <typename T>
 void _forwrite_one_arrf(FILE * f, IOFormat & format, const farray<T> & x) {
@@ -345,7 +377,7 @@ template <typename T>
 void _forwrite_dispatch(FILE * f, IOFormat & format, const farray<T> & x) {
 	_forwrite_one_arrf(f, format, x);
 };
-template <typename T>
+template <typename T, _NOT_FARRAY(T)>
 void _forwrite_dispatch(FILE * f, IOFormat & format, const T & x) {
 	_forwrite_one(f, format, x);
 };
@@ -401,6 +433,9 @@ inline void _forwritefree_one(FILE * f, int x) {
 inline void _forwritefree_one(FILE * f, long long x) {
 	fprintf(f, "%lld", x);
 };
+inline void _forwritefree_one(FILE * f, float x) {
+	fprintf(f, "%f", x);
+};
 inline void _forwritefree_one(FILE * f, double x) {
 	fprintf(f, "%lf", x);
 };
@@ -437,7 +472,7 @@ template <typename T>
 void _forwritefree_dispatch(FILE * f, const farray<T> & x) {
 	_forwritefree_one_arrf(f, x);
 };
-template <typename T>
+template <typename T, _NOT_FARRAY(T)>
 void _forwritefree_dispatch(FILE * f, const T & x) {
 	_forwritefree_one(f, x);
 };
@@ -505,6 +540,49 @@ inline void forprint(const std::string & format) {
 	forwrite(stdout, format);
 };
 
+// io-list with implied-do
+// the translator generates implied-do as `for` loops, which pass items to `item` one by one, ref `gen_io_list_block`
+struct forwritefree_list {
+	forwritefree_list(FILE * _f) : f(_f) {
+
+	}
+	template <typename T>
+	void item(const T & x) {
+		// the same separators as `forwritefree`
+		_forwritefree_dispatch(f, x);
+		fprintf(f, "\t");
+	}
+	void end() {
+		fprintf(f, "\n");
+	}
+
+	FILE * f;
+};
+struct forwrite_list {
+	forwrite_list(FILE * _f, const IOFormat & _format) : f(_f), format(_format) {
+
+	}
+	template <typename T>
+	void item(const T & x) {
+		_forwrite_dispatch(f, format, x);
+	}
+	void end() {
+		// the last editing has ended the record, unless the items ran out before it
+		if (format.p < (size_t)format.reversion_end)
+		{
+			std::string ss = format.strip_front();
+			fprintf(f, ss.c_str());
+			if (ss.empty() || ss.back() != '\n')
+			{
+				fprintf(f, "\n");
+			}
+		}
+	}
+
+	FILE * f;
+	IOFormat format;
+};
+
 
 // read
 inline void _forread_noargs(FILE * f, IOFormat & format) {
@@ -536,6 +614,16 @@ inline void _forread_one(FILE * f, IOFormat & format, std::string & x) {
 	std::string fmt = format.next_editing();
 	_str_fscanf(f, fmt, x);
 };
+inline void _forread_one(FILE * f, IOFormat & format, double & x) {
+	// strip front
+	_forread_noargs(f, format);
+	fscanf(f, _real_editing(format.next_editing(), "l").c_str(), &x);
+};
+inline void _forread_one(FILE * f, IOFormat & format, long double & x) {
+	// strip front
+	_forread_noargs(f, format);
+	fscanf(f, _real_editing(format.next_editing(), "L").c_str(), &x);
+};
 template <typename T>
 void _forread_one_arrf(FILE * f, IOFormat & format, farray<T> & x) {
 	// clear front
@@ -551,7 +639,7 @@ template <typename T>
 void _forread_dispatch(FILE * f, IOFormat & format, farray<T> * x) {
 	_forread_one_arrf(f, format, *x);
 };
-template <typename T>
+template <typename T, _NOT_FARRAY(T)>
 void _forread_dispatch(FILE * f, IOFormat & format, T * x) {
 	_forread_one(f, format, *x);
 };
@@ -601,6 +689,9 @@ inline void _forreadfree_one(FILE * f, int & x) {
 inline void _forreadfree_one(FILE * f, long long & x) {
 	fscanf(f, "%lld", &x);
 };
+inline void _forreadfree_one(FILE * f, float & x) {
+	fscanf(f, "%f", &x);
+};
 inline void _forreadfree_one(FILE * f, double & x) {
 	fscanf(f, "%lf", &x);
 };
@@ -643,7 +734,7 @@ template <typename T>
 void _forreadfree_dispatch(FILE * f, farray<T> * x) {
 	_forreadfree_one_arrf(f, *x);
 };
-template <typename T>
+template <typename T, _NOT_FARRAY(T)>
 void _forreadfree_dispatch(FILE * f, T * x) {
 	_forreadfree_one(f, *x);
 };
@@ -688,6 +779,37 @@ void forreadfree(FILE * f, T&& x, Args &&... args) {
 // void forreadfree(FILE * f, T&& x) {
 // 	_forreadfree_dispatch(f, x);
 // };
+
+// io-list with implied-do, ref `forwritefree_list`
+struct forreadfree_list {
+	forreadfree_list(FILE * _f) : f(_f) {
+
+	}
+	template <typename T>
+	void item(T * x) {
+		_forreadfree_dispatch(f, x);
+	}
+	void end() {
+
+	}
+
+	FILE * f;
+};
+struct forread_list {
+	forread_list(FILE * _f, const IOFormat & _format) : f(_f), format(_format) {
+
+	}
+	template <typename T>
+	void item(T * x) {
+		_forread_dispatch(f, format, x);
+	}
+	void end() {
+
+	}
+
+	FILE * f;
+	IOFormat format;
+};
 #include "forstdio_es.h"
 
 void forrewind(int unit, foroptional<int> iostat, foroptional<forlabel> err);
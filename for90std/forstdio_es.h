@@ -46,6 +46,16 @@ inline void _forread_one(const char * &f, IOFormat & format, std::string & x) {
 	std::string fmt = format.next_editing();
 	_str_sscanf(f, fmt, x);
 };
+inline void _forread_one(const char * &f, IOFormat & format, double & x) {
+	// strip front
+	_forread_noargs(f, format);
+	ADVANCE_SSCANF_FORMAT(f,x,_real_editing(format.next_editing(), "l").c_str())
+};
+inline void _forread_one(const char * &f, IOFormat & format, long double & x) {
+	// strip front
+	_forread_noargs(f, format);
+	ADVANCE_SSCANF_FORMAT(f,x,_real_editing(format.next_editing(), "L").c_str())
+};
 template <typename T>
 void _forread_one_arrf(const char * &f, IOFormat & format, farray<T> & x) {
 	// clear front
@@ -61,7 +71,7 @@ template <typename T>
 void _forread_dispatch(const char * &f, IOFormat & format, farray<T> * x) {
 	_forread_one_arrf(f, format, *x);
 };
-template <typename T>
+template <typename T, _NOT_FARRAY(T)>
 void _forread_dispatch(const char * &f, IOFormat & format, T * x) {
 	_forread_one(f, format, *x);
 };
@@ -158,6 +168,9 @@ inline void _forreadfree_one(const char * &f, int & x) {
 inline void _forreadfree_one(const char * &f, long long & x) {
     ADVANCE_SSCANF(f,x,%lld)
 };
+inline void _forreadfree_one(const char * &f, float & x) {
+    ADVANCE_SSCANF(f,x,%f)
+};
 inline void _forreadfree_one(const char * &f, double & x) {
     ADVANCE_SSCANF(f,x,%lf)
 };
@@ -216,7 +229,7 @@ inline
 void _forreadfree_dispatch(const char * &f, std::string * x) {
     _forreadfree_one(f, *x);
 };
-template <typename T>
+template <typename T, _NOT_FARRAY(T)>
 void _forreadfree_dispatch(const char * &f, T * x) {
 	_forreadfree_one(f, *x);
 };
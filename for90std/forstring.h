@@ -20,6 +20,7 @@
 #pragma once
 #include <string>
 #include <cctype>
+#include <unordered_map>
 
 _NAMESPACE_FORTRAN_BEGIN
 // specialization `forslice` of std::string
@@ -57,4 +58,19 @@ inline std::string foradjustr(std::string s) {
 	return s;
 }
 
+// `select case` of a `character` selector, ref `regen_select`
+//	the index of the case of `value`, or 0 for `case default`
+//	strings are compared as if padded with blanks, so the keys have no trailing blanks
+typedef std::unordered_map<std::string, int> forselect_table;
+inline int forselect_case(const forselect_table & cases, const std::string & value) {
+	size_t len = value.find_last_not_of(' ') + 1; // 0 if `value` is blank
+	auto it = cases.find(len == value.size() ? value : value.substr(0, len));
+	return it == cases.end() ? 0 : it->second;
+}
+
+inline char forselect_char(const std::string & value) {
+	// `character` of length 1
+	return value.empty() ? ' ' : value[0];
+}
+
 _NAMESPACE_FORTRAN_END
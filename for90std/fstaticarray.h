@@ -0,0 +1,167 @@
+/*
+*   Calvin Neo
+*   Copyright (C) 2016  Calvin Neo <calvinneo@calvinneo.com>
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License along
+*   with this program; if not, write to the Free Software Foundation, Inc.,
+*   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#pragma once
+#include "farray.h"
+
+_NAMESPACE_FORTRAN_BEGIN
+template<typename... Dims>
+constexpr fsize_t fa_static_flatsize() {
+	const fsize_t s[] = { 1, Dims::size... };
+	fsize_t x = 1;
+	for (fsize_t y : s)
+	{
+		x *= y;
+	}
+	return x;
+}
+
+// one dimension of a `fstaticarray`, `L:L+S-1`
+template <fsize_t L, fsize_t S>
+struct fstaticdim {
+	static constexpr fsize_t lower = L;
+	static constexpr fsize_t size = S;
+};
+
+/****************
+* the constant shape of a `fstaticarray` or a `fstaticview`
+*	`a(i, j)` uses constant strides, which are folded by the compiler
+****************/
+template <typename T, typename... Dims>
+struct fstaticshape : public farray<T> {
+	static constexpr int rank = sizeof...(Dims);
+	static constexpr fsize_t static_flatsize = fa_static_flatsize<Dims...>();
+
+	using farray<T>::operator=;
+
+protected:
+	static constexpr fsize_t lower(int d) {
+		const fsize_t l[] = { Dims::lower... };
+		return l[d];
+	}
+	static constexpr fsize_t stride(int d) {
+		const fsize_t s[] = { Dims::size... };
+		fsize_t x = 1;
+		for (int i = 0; i < d; i++)
+		{
+			x *= s[i];
+		}
+		return x;
+	}
+	template<typename... Args>
+	static fsize_t offset(Args&&... args) {
+		static_assert(sizeof...(Args) == rank, "wrong number of subscripts");
+		const fsize_t index[] = { (fsize_t)args... };
+		fsize_t off = 0;
+		for (int d = 0; d < rank; d++)
+		{
+			assert(index[d] >= lower(d));
+			off += (index[d] - lower(d)) * stride(d);
+		}
+		assert(off < static_flatsize);
+		return off;
+	}
+	void bind(T * storage) {
+		const fsize_t l[] = { Dims::lower... }, s[] = { Dims::size... };
+		std::copy_n(l, rank, lb_storage);
+		std::copy_n(s, rank, sz_storage);
+		fa_layer_delta(sz_storage, sz_storage + rank, delta_storage);
+		this->dimension = rank;
+		this->lb = lb_storage;
+		this->sz = sz_storage;
+		this->delta = delta_storage;
+		this->parr = storage;
+		this->fixed = true;
+	}
+
+	fsize_t lb_storage[rank], sz_storage[rank], delta_storage[rank];
+};
+
+/****************
+* an array whose bounds are all constants, like `real a(10, 0:4)`
+*	the elements and the bounds are stored inside the object instead of the heap
+*	, so a local array lives on the stack
+*	it is a `farray<T>`, so it can be passed wherever `farray<T>` is accepted
+****************/
+template <typename T, typename... Dims>
+struct fstaticarray : public fstaticshape<T, Dims...> {
+	using fstaticshape<T, Dims...>::static_flatsize;
+
+	fstaticarray() noexcept {
+		this->bind(storage);
+		std::fill_n(storage, static_flatsize, T{});
+	}
+	fstaticarray(const fstaticarray & m) noexcept {
+		this->bind(storage);
+		std::copy_n(m.storage, static_flatsize, storage);
+	}
+	fstaticarray(const farray<T> & m) noexcept {
+		// the shape is fixed, so `m` must conform to it
+		assert(m.flatsize() == static_flatsize);
+		this->bind(storage);
+		this->reset_value(m.cbegin(), m.cend());
+	}
+	fstaticarray & operator=(const fstaticarray & x) {
+		std::copy_n(x.storage, static_flatsize, storage);
+		return *this;
+	}
+	using farray<T>::operator=;
+
+	template<typename... Args>
+	T & operator()(Args&&... args) {
+		return storage[this->offset(std::forward<Args>(args)...)];
+	}
+	template<typename... Args>
+	const T & operator()(Args&&... args) const {
+		return storage[this->offset(std::forward<Args>(args)...)];
+	}
+
+	T storage[static_flatsize];
+};
+
+/****************
+* an array of constant bounds whose elements are stored elsewhere, like a member of a common block
+*	, ref `gen_common_definition`
+*	the storage is owned by the caller, so it is never released, and the view can't be copied
+****************/
+template <typename T, typename... Dims>
+struct fstaticview : public fstaticshape<T, Dims...> {
+	using fstaticshape<T, Dims...>::static_flatsize;
+
+	explicit fstaticview(T * storage) noexcept {
+		this->bind(storage);
+	}
+	fstaticview(const fstaticview &) = delete;
+	fstaticview & operator=(const fstaticview & x) {
+		std::copy_n(x.parr, static_flatsize, this->parr);
+		return *this;
+	}
+	using farray<T>::operator=;
+
+	template<typename... Args>
+	T & operator()(Args&&... args) {
+		return this->parr[this->offset(std::forward<Args>(args)...)];
+	}
+	template<typename... Args>
+	const T & operator()(Args&&... args) const {
+		return this->parr[this->offset(std::forward<Args>(args)...)];
+	}
+};
+_NAMESPACE_FORTRAN_END
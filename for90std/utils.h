@@ -192,8 +192,17 @@ inline char to_lower(char ch) {
 };
 
 #define FW(X) std::move(X)
-#define INOUT(X) std::move(X)
+#define INOUT(X) forarg(X)
 #define IN(X) X
 #define OUT(X) X
 #define SS(X) std::string(X)
+
+// `pure` functions, `FOR_CONST` ones read nothing but their arguments
+#if defined(__GNUC__)
+#define FOR_PURE __attribute__((pure))
+#define FOR_CONST __attribute__((const))
+#else
+#define FOR_PURE
+#define FOR_CONST
+#endif
 _NAMESPACE_FORTRAN_END
\ No newline at end of file
@@ -126,7 +126,7 @@ int _getopt_impl(int argc, char * const argv[], const char * optstring, const st
 		else if (longopptr->flag == nullptr)
 		{
 			// use short name case
-			optname = longopptr->name[0];
+			optname = longopptr->val;
 			goto HANDLE_CACHED;
 		}
 		else {
@@ -159,7 +159,13 @@
      YY_PAUSE = 375,
      YY_RETURN = 376,
      YY_CONFIG_IMPLICIT = 377,
-     YY_ALLOCATE = 378
+     YY_ALLOCATE = 378,
+     YY_DOCONCURRENT = 379,
+     YY_FORALL = 380,
+     YY_ENDFORALL = 381,
+     YY_ELSEWHERE = 382,
+     YY_PURE = 383,
+     YY_ELEMENTAL = 384
    };
 #endif
 /* Tokens.  */
@@ -284,6 +290,12 @@
 #define YY_RETURN 376
 #define YY_CONFIG_IMPLICIT 377
 #define YY_ALLOCATE 378
+#define YY_DOCONCURRENT 379
+#define YY_FORALL 380
+#define YY_ENDFORALL 381
+#define YY_ELSEWHERE 382
+#define YY_PURE 383
+#define YY_ELEMENTAL 384
 
 
 
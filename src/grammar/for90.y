@@ -110,6 +110,9 @@ using namespace std;
 %token /*_YY_COMMAND*/ YY_WRITE YY_READ YY_PRINT YY_CALL  YY_STOP YY_PAUSE YY_RETURN
 %token /*_YY_CONFIG*/ YY_CONFIG_IMPLICIT
 %token /*_YY_SYSFUNCTION*/ YY_ALLOCATE
+%token /*_YY_CONCURRENT*/ YY_DOCONCURRENT YY_FORALL YY_ENDFORALL
+%token /*_YY_WHERE*/ YY_ELSEWHERE
+%token /*_YY_PREFIX*/ YY_PURE YY_ELEMENTAL
 
 
 /******************* 
@@ -129,8 +132,11 @@ using namespace std;
 %right YY_NOT
 %left YY_EQ YY_NEQ
 %left YY_GT YY_GE YY_LE YY_LT
-%right YY_NEG YY_POS
-%left '+' '-' 
+/******************* 
+* unary '-' and '+' are at the level of binary '+' and '-'
+* -a-b -> (-a)-b, -a*b -> -(a*b)
+*******************/
+%left '+' '-' YY_NEG YY_POS
 %left '*' '/' 
 /******************* 
 * YY_POWER is right associative
@@ -188,7 +194,40 @@ using namespace std;
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
 			}
 
-	dummy_function_iden : YY_RECURSIVE
+	function_prefix_elem : YY_RECURSIVE
+			{
+				$$ = $1;
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
+			}
+		| YY_PURE
+			{
+				$$ = $1;
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
+			}
+		| YY_ELEMENTAL
+			{
+				$$ = $1;
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
+			}
+
+	function_prefix : function_prefix_elem
+			{
+				// prefixes of a subprogram, ref `set_function_prefix`
+				ParseNode newnode = gen_token(Term{ TokenMeta::META_ANY, "" }, YY2ARG($1));
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
+				CLEAN_DELETE($1);
+			}
+		| function_prefix function_prefix_elem
+			{
+				ARG_OUT prefix = YY2ARG($1);
+				prefix.addchild(YY2ARG($2));
+				$$ = RETURN_NT(prefix);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($2));
+				CLEAN_DELETE($1, $2);
+			}
+
+	dummy_function_iden : function_prefix
 			{
 				$$ = $1;
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
@@ -380,6 +419,13 @@ using namespace std;
                 update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($3));
                 CLEAN_DELETE($1, $2, $3);
             }
+        | YY_KIND '=' variable
+            {
+                /* `real(kind=dp)` is `real(dp)` */
+                $$ = $3;
+                update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($3));
+                CLEAN_DELETE($1, $2);
+            }
         | YY_LEN '=' exp
             {
                 // though use std::string
@@ -463,7 +509,7 @@ using namespace std;
 			{
 				// all arguments under `literal` rule is directly from tokenizer
 				ARG_OUT lit = YY2ARG($1);
-				$$ = RETURN_NT(gen_token(Term{ TokenMeta::Float, lit.get_what() })); // float number
+				$$ = RETURN_NT(gen_real_literal(lit.get_what())); // float number
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
 				CLEAN_DELETE($1);
 			}
@@ -471,7 +517,7 @@ using namespace std;
 			{
 				ARG_OUT base = YY2ARG($1);
 				ARG_OUT expo = YY2ARG($3);
-				$$ = RETURN_NT(gen_token(Term{ TokenMeta::Float,  base.get_what() + "e" + expo.get_what() })); // float number
+				$$ = RETURN_NT(gen_real_literal(base.get_what() + "e" + expo.get_what())); // float number
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($3));
 				CLEAN_DELETE($1, $2, $3);
 			}
@@ -479,7 +525,8 @@ using namespace std;
 		| YY_INTEGER
 			{
 				ARG_OUT lit = YY2ARG($1);
-				$$ = RETURN_NT(gen_token(Term{ TokenMeta::Int, lit.get_what() })); // int number
+				// the kind-param of an int literal is dropped, the value is converted where it is used
+				$$ = RETURN_NT(gen_token(Term{ TokenMeta::Int, lit.get_what().substr(0, lit.get_what().find('_')) })); // int number
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
 				CLEAN_DELETE($1);
 			}
@@ -1239,6 +1286,16 @@ using namespace std;
 				$$ = $1;
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
 			}
+		| concurrent_stmt
+			{
+				$$ = $1;
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
+			}
+		| where_stmt
+			{
+				$$ = $1;
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
+			}
 		| select_stmt
 			{
 				$$ = $1;
@@ -1266,7 +1323,6 @@ using namespace std;
 			}
 		| YY_GOTO '(' paramtable ')' ',' exp
 			{
-				printf("============");
 				ARG_OUT options = YY2ARG($3);
 				ARG_OUT exp = YY2ARG($6);
 				$$ = RETURN_NT(gen_token(Term{TokenMeta::Goto, "branch"}));
@@ -1373,7 +1429,7 @@ using namespace std;
 				        initialized = true;
 				    }
 				}
-				$$ = RETURN_NT(newGroup);
+				$$ = RETURN_NT(gen_promote("%s", TokenMeta::NT_DATA, newGroup));
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($5));
 				CLEAN_DELETE($1, $2, $3, $4, $5);
 		    }
@@ -2340,6 +2396,13 @@ using namespace std;
 				// Arithmetic if
 				// `IF (e) s1, s2, s3`, where
 				// s1, s2, s3 are labels
+				// same children as computed goto, ref `regen_computed_goto`
+				ARG_OUT exp = YY2ARG($4);
+				ParseNode labels = gen_token(Term{ TokenMeta::NT_ARGTABLE_PURE, "" }, YY2ARG($6), YY2ARG($8), YY2ARG($10));
+				ParseNode jump = gen_token(Term{ TokenMeta::Goto, "arithmetic" }, labels, exp);
+				$$ = RETURN_NT(gen_promote("%s", TokenMeta::NT_CONTROL_STMT, jump));
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($10));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7, $8, $9, $10);
 			}
 		| _optional_construct_name YY_IF '(' exp ')' YY_THEN at_least_one_end_line /* must have \n */ suite YY_ENDIF
 			{
@@ -2456,6 +2519,166 @@ using namespace std;
 				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7, $8);
 			}
 	
+	concurrent_control : variable '=' exp ':' exp
+			{
+				ARG_OUT loop_variable = YY2ARG($1);
+				ARG_OUT exp_from = YY2ARG($3);
+				ARG_OUT exp_to = YY2ARG($5);
+				ParseNode step = gen_token(Term{ TokenMeta::META_INTEGER , UBOUND_DELTA_STR });
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_CONCURRENT_CONTROL, WHEN_DEBUG_OR_EMPTY("CONCURRENT-CONTROL GENERATED IN REGEN_SUITE") }, loop_variable, exp_from, exp_to, step);
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($5));
+				CLEAN_DELETE($1, $2, $3, $4, $5);
+			}
+		| variable '=' exp ':' exp ':' exp
+			{
+				ARG_OUT loop_variable = YY2ARG($1);
+				ARG_OUT exp_from = YY2ARG($3);
+				ARG_OUT exp_to = YY2ARG($5);
+				ARG_OUT step = YY2ARG($7);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_CONCURRENT_CONTROL, WHEN_DEBUG_OR_EMPTY("CONCURRENT-CONTROL GENERATED IN REGEN_SUITE") }, loop_variable, exp_from, exp_to, step);
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($7));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7);
+			}
+
+	concurrent_controls : concurrent_control
+			{
+				ARG_OUT concurrent_control = YY2ARG($1);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_CONCURRENT_HEADER, WHEN_DEBUG_OR_EMPTY("CONCURRENT-HEADER GENERATED IN REGEN_SUITE") }, concurrent_control);
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($1));
+				CLEAN_DELETE($1);
+			}
+		| concurrent_controls ',' concurrent_control
+			{
+				// controls are in source order, the first one is the outermost loop
+				$$ = $1;
+				YY2ARG($$).addchild(YY2ARG($3));
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($3));
+				CLEAN_DELETE($2, $3);
+			}
+
+	concurrent_header : '(' concurrent_controls ')'
+			{
+				// the last child is the mask, which is always true if not given
+				$$ = $2;
+				YY2ARG($$).addchild(gen_dummy());
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($3));
+				CLEAN_DELETE($1, $3);
+			}
+		| '(' concurrent_controls ',' exp ')'
+			{
+				$$ = $2;
+				YY2ARG($$).addchild(YY2ARG($4));
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($5));
+				CLEAN_DELETE($1, $3, $4, $5);
+			}
+
+	construct_suite : end_of_stmt suite
+			{
+				/***********
+				* the body of a construct, after the line of its header
+				*	blank lines after the header are empty stmts of `suite`
+				*	, instead of `at_least_one_end_line`, which conflicts with them
+				***********/
+				$$ = $2;
+				update_pos(YY2ARG($$), YY2ARG($2), YY2ARG($2));
+				CLEAN_DELETE($1);
+			}
+
+	concurrent_stmt : _optional_construct_name YY_DOCONCURRENT concurrent_header construct_suite crlf_or_not YY_ENDDO _optional_construct_end_name
+			{
+				ARG_OUT concurrent_header = YY2ARG($3);
+				ARG_OUT suite = YY2ARG($4);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_CONCURRENT, WHEN_DEBUG_OR_EMPTY("DO-CONCURRENT GENERATED IN REGEN_SUITE") }, concurrent_header, suite, YY2ARG($1));
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($7));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7);
+			}
+		| _optional_construct_name YY_FORALL concurrent_header construct_suite crlf_or_not YY_ENDFORALL _optional_construct_end_name
+			{
+				ARG_OUT concurrent_header = YY2ARG($3);
+				ARG_OUT suite = YY2ARG($4);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_FORALL, WHEN_DEBUG_OR_EMPTY("FORALL GENERATED IN REGEN_SUITE") }, concurrent_header, suite, YY2ARG($1));
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($7));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7);
+			}
+		| _optional_construct_name YY_FORALL concurrent_header let_stmt
+			{
+				// forall statement, which has only one assignment
+				ARG_OUT concurrent_header = YY2ARG($3);
+				ParseNode stmt = gen_promote("%s;", TokenMeta::NT_STATEMENT, YY2ARG($4));
+				update_pos(stmt, YY2ARG($4), YY2ARG($4));
+				ParseNode suite = gen_suite(stmt, gen_dummy());
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_FORALL, WHEN_DEBUG_OR_EMPTY("FORALL GENERATED IN REGEN_SUITE") }, concurrent_header, suite, YY2ARG($1));
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($4));
+				CLEAN_DELETE($1, $2, $3, $4);
+			}
+
+	where_stmt : _optional_construct_name YY_WHERE '(' exp ')' let_stmt
+			{
+				// where statement, which has only one assignment
+				ARG_OUT exp = YY2ARG($4);
+				ParseNode stmt = gen_promote("%s;", TokenMeta::NT_STATEMENT, YY2ARG($6));
+				update_pos(stmt, YY2ARG($6), YY2ARG($6));
+				ParseNode suite = gen_suite(stmt, gen_dummy());
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_WHERE, WHEN_DEBUG_OR_EMPTY("WHERE GENERATED IN REGEN_SUITE") }, exp, suite, gen_dummy());
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($6));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6);
+			}
+		| _optional_construct_name YY_WHERE '(' exp ')' construct_suite YY_ENDWHERE _optional_construct_end_name
+			{
+				ARG_OUT exp = YY2ARG($4);
+				ARG_OUT suite = YY2ARG($6);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_WHERE, WHEN_DEBUG_OR_EMPTY("WHERE GENERATED IN REGEN_SUITE") }, exp, suite, gen_dummy());
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($8));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7, $8);
+			}
+		| _optional_construct_name YY_WHERE '(' exp ')' construct_suite elsewhere_stmt YY_ENDWHERE _optional_construct_end_name
+			{
+				ARG_OUT exp = YY2ARG($4);
+				ARG_OUT suite = YY2ARG($6);
+				ARG_OUT elsewhere = YY2ARG($7);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_WHERE, WHEN_DEBUG_OR_EMPTY("WHERE GENERATED IN REGEN_SUITE") }, exp, suite, elsewhere);
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($9));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7, $8, $9);
+			}
+
+	elsewhere_stmt : YY_ELSEWHERE '(' exp ')' construct_suite
+			{
+				ARG_OUT exp = YY2ARG($3);
+				ARG_OUT suite = YY2ARG($5);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_ELSEWHERE, WHEN_DEBUG_OR_EMPTY("ELSEWHERE GENERATED IN REGEN_SUITE") }, exp, suite, gen_dummy());
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($5));
+				CLEAN_DELETE($1, $2, $3, $4, $5);
+			}
+		| YY_ELSEWHERE '(' exp ')' construct_suite elsewhere_stmt
+			{
+				ARG_OUT exp = YY2ARG($3);
+				ARG_OUT suite = YY2ARG($5);
+				ARG_OUT elsewhere = YY2ARG($6);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_ELSEWHERE, WHEN_DEBUG_OR_EMPTY("ELSEWHERE GENERATED IN REGEN_SUITE") }, exp, suite, elsewhere);
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($6));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6);
+			}
+		| YY_ELSEWHERE construct_suite
+			{
+				// the mask of the last `elsewhere` is omitted
+				ARG_OUT suite = YY2ARG($2);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_ELSEWHERE, WHEN_DEBUG_OR_EMPTY("ELSEWHERE GENERATED IN REGEN_SUITE") }, gen_dummy(), suite, gen_dummy());
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($2));
+				CLEAN_DELETE($1, $2);
+			}
+
 	select_stmt : _optional_construct_name YY_SELECT YY_CASE '(' exp ')' at_least_one_end_line case_stmt YY_ENDSELECT _optional_construct_end_name
 			{
 				ARG_OUT select = YY2ARG($2);
@@ -2574,34 +2797,38 @@ using namespace std;
 				ARG_OUT suite = YY2ARG($9);
 
 				ParseNode kvparamtable = promote_argtable_to_paramtable(paramtable); // a flattened parameter list with all keyvalue elements
-				ParseNode newnode = gen_token(Term{ TokenMeta::NT_FUNCTIONDECLARE, "" }, gen_dummy(), variable_function, kvparamtable, variable_result, suite);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_FUNCTIONDECLARE, "" }, YY2ARG($1), variable_function, kvparamtable, variable_result, suite);
 				$$ = RETURN_NT(newnode);
 
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($11));
 				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11);
 			}
-		| type_name YY_FUNCTION YY_WORD '(' paramtable ')' _optional_result at_least_one_end_line suite _optional_endfunction _optional_name
+		| typed_function_head YY_WORD '(' paramtable ')' _optional_result at_least_one_end_line suite _optional_endfunction _optional_name
 			{
-				ARG_OUT variable_function = YY2ARG($3); // function name
+				ARG_OUT function_head = YY2ARG($1); // prefixes and type
+				ARG_OUT variable_function = YY2ARG($2); // function name
 				// enumerate parameter list
-				ARG_OUT paramtable = YY2ARG($5);
+				ARG_OUT paramtable = YY2ARG($4);
 
 				ParseNode var_desc = (gen_token(Term{ TokenMeta::NT_VARIABLEDESC, WHEN_DEBUG_OR_EMPTY("NT_VARIABLEDESC GENERATED IN") }));
 				set_variabledesc_attr(var_desc, boost::none, boost::none, boost::none, boost::none, boost::none, boost::none, boost::none, boost::none, boost::none, boost::none);
-				ParseNode variable = (gen_token(Term{ TokenMeta::UnknownVariant, variable_function.get_what()}));
+				// the result variable is named by `result(r)`, or is the function name
+				ARG_OUT variable_result = YY2ARG($6);
+				std::string result_name = variable_result.get_what().empty() ? variable_function.get_what() : variable_result.get_what();
+				ParseNode variable = (gen_token(Term{ TokenMeta::UnknownVariant, result_name }));
 				ParseNode var_param = gen_token(Term{ TokenMeta::NT_ARGTABLE_PURE , variable.get_what()}, variable);
-				ParseNode ret_val = gen_vardef(YY2ARG($1), var_desc, var_param);
-				ret_val.get_what() = variable_function.get_what();
+				ParseNode ret_val = gen_vardef(function_head.get(1), var_desc, var_param);
+				ret_val.get_what() = result_name;
 
-				ARG_OUT suite = YY2ARG($9);
+				ARG_OUT suite = YY2ARG($8);
 				suite.addchild(ret_val,false);/* so that the return variable definition will be generated when regen_stmt */
 
 				ParseNode kvparamtable = promote_argtable_to_paramtable(paramtable); // a flattened parameter list with all keyvalue elements
-				ParseNode newnode = gen_token(Term{ TokenMeta::NT_FUNCTIONDECLARE, "" }, gen_dummy(), variable_function, kvparamtable, ret_val, suite);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_FUNCTIONDECLARE, "" }, function_head.get(0), variable_function, kvparamtable, ret_val, suite);
 				$$ = RETURN_NT(newnode);
 
-				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($11));
-				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($10));
+				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7, $8, $9, $10);
 			}
 		| dummy_function_iden _optional_function YY_WORD at_least_one_end_line suite _optional_endfunction _optional_name
 			{
@@ -2610,12 +2837,34 @@ using namespace std;
 
 				ParseNode kvparamtable = gen_token(Term{ TokenMeta::NT_PARAMTABLE_PURE, "" });
 				ParseNode void_return = gen_token(Term{ TokenMeta::UnknownVariant, "" });
-				ParseNode newnode = gen_token(Term{ TokenMeta::NT_FUNCTIONDECLARE, "" }, gen_dummy(), variable_function, kvparamtable, void_return, suite);
+				ParseNode newnode = gen_token(Term{ TokenMeta::NT_FUNCTIONDECLARE, "" }, YY2ARG($1), variable_function, kvparamtable, void_return, suite);
 				$$ = RETURN_NT(newnode);
 
 				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($7));
 				CLEAN_DELETE($1, $2, $3, $4, $5, $6, $7);
 			}
+	typed_function_head : type_name YY_FUNCTION
+			{
+				ParseNode newnode = gen_token(Term{ TokenMeta::META_ANY, "" }, gen_dummy(), YY2ARG($1));
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($2));
+				CLEAN_DELETE($1, $2);
+			}
+		| function_prefix type_name YY_FUNCTION
+			{
+				ParseNode newnode = gen_token(Term{ TokenMeta::META_ANY, "" }, YY2ARG($1), YY2ARG($2));
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($3));
+				CLEAN_DELETE($1, $2, $3);
+			}
+		| type_name function_prefix YY_FUNCTION
+			{
+				ParseNode newnode = gen_token(Term{ TokenMeta::META_ANY, "" }, YY2ARG($2), YY2ARG($1));
+				$$ = RETURN_NT(newnode);
+				update_pos(YY2ARG($$), YY2ARG($1), YY2ARG($3));
+				CLEAN_DELETE($1, $2, $3);
+			}
+
 	_optional_name : YY_WORD
 			{
 				$$ = $1;
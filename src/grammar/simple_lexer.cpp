@@ -25,6 +25,7 @@
 #include <functional>
 #include <numeric>
 #include <iterator>
+#include <algorithm>
 #include "../target/gen_config.h"
 #include "for90.tab.h"
 #include "simple_lexer.h"
@@ -76,6 +77,81 @@ static char to_lower(char ch) {
 	return ch;
 };
 
+static bool is_omp_sentinel(const std::string & comment) {
+	// `!$omp` in free form, `c$omp` in fixed form, case insensitive
+	if (comment.size() < 5)
+	{
+		return false;
+	}
+	std::string sentinel;
+	std::transform(comment.begin(), comment.begin() + 5, std::back_inserter(sentinel), to_lower);
+	return sentinel == "!$omp" || sentinel == "c$omp";
+}
+
+static void log_omp_directive(int pos, const std::string & comment) {
+	/****************
+	* a directive line ending with `&`, or followed by a sentinel line starting with `&`(free form)
+	*	or any other non-blank char(column 6 of fixed form), continues to the next sentinel line
+	****************/
+	std::vector<std::tuple<int, std::string>> & directives = get_tokenizer_context().directives;
+	std::string text = comment.substr(5);
+	while (!text.empty() && is_blank(text.back()))
+	{
+		text.pop_back();
+	}
+	bool continued = !directives.empty() && !std::get<1>(directives.back()).empty() && std::get<1>(directives.back()).back() == '&';
+	if (!text.empty() && !is_blank(text[0]))
+	{
+		continued = !directives.empty();
+		text = text.substr(1);
+	}
+	if (continued)
+	{
+		std::string & last = std::get<1>(directives.back());
+		if (last.back() == '&')
+		{
+			last.pop_back();
+		}
+		last += " " + text;
+	}
+	else {
+		directives.push_back(std::make_tuple(pos, text));
+	}
+}
+
+static void log_soa_directive(const std::string & comment) {
+	/****************
+	* `!dir$ soa point, particle` in free form, `cdir$ soa ...` in fixed form
+	*	stores arrays of the listed derived types as struct-of-arrays, like `--soa`
+	****************/
+	std::string text;
+	std::transform(comment.begin(), comment.end(), std::back_inserter(text), to_lower);
+	if (text.size() < 5 || (text.compare(0, 5, "!dir$") != 0 && text.compare(0, 5, "cdir$") != 0))
+	{
+		return;
+	}
+	size_t p = text.find_first_not_of(" \t", 5);
+	if (p == std::string::npos || text.compare(p, 3, "soa") != 0 || (p + 3 < text.size() && !is_blank(text[p + 3])))
+	{
+		return;
+	}
+	std::string name;
+	for (size_t i = p + 3; i <= text.size(); i++)
+	{
+		if (i == text.size() || text[i] == ',' || is_blank(text[i]))
+		{
+			if (!name.empty())
+			{
+				get_context().soa_types.insert(name);
+			}
+			name = "";
+		}
+		else {
+			name += text[i];
+		}
+	}
+}
+
 static bool check_continuation(char & return_char) {
 	return_char = 0;
 	SimplerContext & sc = get_simpler_context();
@@ -221,6 +297,7 @@ static char get_complete_char() {
 	}
 	else if (is_normal_parse() && is_comment_beginning(s[p])) {
 		std::string comment_str;
+		int comment_pos = p;
 		while (p < s.size() && s[p] != '\n') {
 			if (s[p] == '\r')
 			{
@@ -236,9 +313,22 @@ static char get_complete_char() {
 			p++;
 		}
 		// now s[p] == '\n'
-		if (check_continuation(return_char)) {
+		if (get_context().parse_config.openmp && is_omp_sentinel(comment_str))
+		{
+			// a trailing `&` continues to the next sentinel line rather than the next stmt
+			// so do not `check_continuation`, just return the '\n'
+			log_omp_directive(comment_pos, comment_str);
+			if (p < s.size())
+			{
+				return_char = s[p++];
+			}
+		}
+		else {
+			log_soa_directive(comment_str);
+			if (check_continuation(return_char)) {
+			}
+			get_tokenizer_context().comments.push_back(comment_str);
 		}
-		get_tokenizer_context().comments.push_back(comment_str);
 		handle_newline();
 	}
 	else if (s[p] == ' ' || is_int(s[p]))
@@ -657,7 +747,8 @@ static bool check_expo(const std::string & pre, std::string & res) {
 	char exp_mark = pull_complete_char();
 	if (is_within(exp_mark, std::vector<char>{ 'E', 'e', 'D', 'd'}))
 	{
-		res += "e";
+		// keep exponent letter `d`, which makes a double precision real, ref `gen_real_literal`
+		res += (exp_mark == 'D' || exp_mark == 'd') ? "d" : "e";
 		AGAIN:
 		next_nonblank_item(cur);
 		if (is_int(cur[0]))
@@ -688,6 +779,27 @@ static bool check_expo(const std::string & pre, std::string & res) {
 	return flag;
 }
 
+static bool check_kind_param(std::string & res) {
+	//R413 real-literal-constant is significand [exponent-letter exponent] [_ kind-param]
+	//R404 int-literal-constant is digit-string [_ kind-param]
+	//	e.g. `2.0_8`, `.93E7_QUAD`. `_singr`, `_fullr`, ... are keywords and are parsed as `literal_tail`
+	SimplerContext & sc = get_simpler_context();
+	std::string cur;
+	next_item(cur);
+	std::string lowercase_name = cur;
+	std::transform(lowercase_name.begin(), lowercase_name.end(), lowercase_name.begin(), to_lower);
+	bool is_kind_param = lowercase_name.size() > 1 && lowercase_name[0] == '_'
+		&& find_if(keywords.begin(), keywords.end(), [&](const KeywordMeta & x) {return x.what == lowercase_name; }) == keywords.end();
+	if (is_kind_param)
+	{
+		res += lowercase_name;
+	}
+	else if (cur != "") {
+		sc.item_cache.push_back(cur);
+	}
+	return is_kind_param;
+}
+
 static void check_keyword(const std::string name, std::function<void(const KeywordMeta &, const std::string &)> keyword_handler
 	, std::function<void(const std::string &)> non_keyword_handler) {
 	SimplerContext & sc = get_simpler_context();
@@ -746,10 +858,12 @@ NOP_REPEAT:
 			bool is_expo = check_expo(res, cur2);
 			if (is_fl || is_expo)
 			{
+				check_kind_param(cur2);
 				return_term = Term{ TokenMeta::Float, cur2 };
 				return_token = YY_FLOAT;
 			}
 			else {
+				check_kind_param(res);
 				return_term = Term{ TokenMeta::Int, res };
 				return_token = YY_INTEGER;
 			}
@@ -878,6 +992,7 @@ NOP_REPEAT:
 			if (is_fl)
 			{
 				check_expo(res, res);
+				check_kind_param(res);
 				return_term = Term{ TokenMeta::Float, res };
 				return_token = YY_FLOAT;
 			}
@@ -43,18 +43,32 @@ int main(int argc, char* argv[], char* env[])
 	int opt;
 	std::string code;
 	int print_tree = (int)false;
+	int line_directive = (int)false;
+	int openmp = (int)false;
+	int autopar = (int)false;
+	int restrict_dummies = (int)false;
+	int default_real_kind = 0;
+	int instrument = (int)false;
 	struct option opts[] = { 
 		{ "fortran", optional_argument, nullptr, 'F' },
-		{ "file", required_argument, nullptr, 'v' },
+		{ "file", required_argument, nullptr, 'f' },
 		{ "debug", no_argument, nullptr, 'd' },
 		{ "tree", no_argument, &print_tree, true },
+		{ "line", no_argument, &line_directive, true },
+		{ "openmp", no_argument, &openmp, true },
+		{ "autopar", no_argument, &autopar, true },
+		{ "restrict", no_argument, &restrict_dummies, true },
+		{ "default-real-kind", required_argument, nullptr, 'r' },
+		{ "soa", required_argument, nullptr, 's' },
+		{ "instrument", no_argument, &instrument, true },
 		{ 0, 0, 0, 0 } 
 	};
 
-	while ((opt = getopt_long(argc, argv, "df:F::p", opts, nullptr)) != -1) {
+	while ((opt = getopt_long(argc, argv, "df:F::pr:s:", opts, nullptr)) != -1) {
 		if (opt == 'f')
 		{
 			get_context().parse_config.hasfile = true;
+			get_context().parse_config.filename = optarg;
 			fstream f;
 			f.open(optarg, ios::in);
 			code = std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
@@ -72,12 +86,52 @@ int main(int argc, char* argv[], char* env[])
 			// debug
 			get_context().parse_config.isdebug = true;
 		}
+		else if (opt == 'r') {
+			// --default-real-kind 4|8|16
+			default_real_kind = atoi(optarg);
+			if (default_real_kind != 4 && default_real_kind != 8 && default_real_kind != 16)
+			{
+				fprintf(stderr, "default real kind must be 4, 8 or 16: %s\n", optarg);
+				return 1;
+			}
+		}
+		else if (opt == 's') {
+			// --soa point,particle
+			std::string name;
+			for (const char * p = optarg; ; p++)
+			{
+				if (*p == '\0' || *p == ',')
+				{
+					if (!name.empty())
+					{
+						get_context().parse_config.soa_types.insert(name);
+					}
+					name = "";
+					if (*p == '\0')
+					{
+						break;
+					}
+				}
+				else {
+					name += (char)tolower(*p);
+				}
+			}
+		}
 		else if (opt == 'C') {
 			// use c style
 			get_context().parse_config.usefor = false;
 		}
 	}
 	get_context().parse_config.usefarray = true;
+	get_context().parse_config.line_directive = line_directive;
+	get_context().parse_config.openmp = openmp;
+	get_context().parse_config.autopar = autopar;
+	get_context().parse_config.restrict_dummies = restrict_dummies;
+	get_context().parse_config.instrument = instrument;
+	if (default_real_kind != 0)
+	{
+		get_context().parse_config.default_real_kind = default_real_kind;
+	}
 	if (get_context().parse_config.isdebug) {
 		debug();
 	}
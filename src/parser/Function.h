@@ -44,13 +44,19 @@ struct FunctionInfo {
 	std::string local_name; // name can only set by add_function
 	std::string result_name;
 	FunctionDesc funcdesc;
-	ParseNode * suite;
-	ParseNode * node;
+	ParseNode * suite = nullptr;
+	ParseNode * node = nullptr;
 	TokenMeta_T implicit_type_config[256];
     std::vector<ParseNode *> use_stmts;
     std::vector < std::string> func_alias;
+	// `pure` and `elemental` prefixes, an `elemental` function is also `pure`, ref `set_function_prefix`
+	bool pure = false;
+	bool elemental = false;
+	// its variables are generated at namespace scope, like these of a module or `block data`
+	bool global_scope = false;
 	FunctionInfo() {
-		std::fill_n(implicit_type_config, 256, TokenMeta::Double_Decl);
+		// default real, ref `gen_real_term`
+		std::fill_n(implicit_type_config, 256, TokenMeta::Float_Decl);
 		for (char i = 'i'; i <= 'n'; i++)
 		{
 			implicit_type_config[i] = TokenMeta::Int_Decl;
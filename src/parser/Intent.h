@@ -362,6 +362,13 @@ namespace TokenMeta {
         ADD_ENUM(NT_MODULE, -2053),
         ADD_ENUM(NT_USE, -2054),
         ADD_ENUM(NT_BLOCKDATA, -2055),
+		ADD_ENUM(NT_CONCURRENT, -2056),
+		ADD_ENUM(NT_FORALL, -2057),
+		ADD_ENUM(NT_CONCURRENT_HEADER, -2058),
+		ADD_ENUM(NT_CONCURRENT_CONTROL, -2059),
+		ADD_ENUM(NT_WHERE, -2060),
+		ADD_ENUM(NT_ELSEWHERE, -2061),
+		ADD_ENUM(NT_DATA, -2062),
 
 		ADD_ENUM(NT_DUMMY, -9999),
 		/***************************************
@@ -50,4 +50,5 @@ void clear_types() {
 		delete pr.second;
 	}
 	get_context().types.clear();
+	get_context().types_vec.clear();
 }
\ No newline at end of file
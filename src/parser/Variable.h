@@ -217,10 +217,14 @@ struct VariableInfo
 	}
 };
 
+struct FunctionInfo;
 struct CommonBlockInfo {
 	std::string common_name;
 	std::vector<VariableInfo *> variables;
 	bool elsewhere_decl = false;
+	// members of this block in every subprogram which declares it, in order, ref `gen_common_definition`
+	std::vector<std::pair<FunctionInfo *, std::vector<VariableInfo *>>> layouts;
+	bool storage_associated = false;
 	CommonBlockInfo() {
 
 	}
@@ -23,6 +23,16 @@
 #include "../parser/Type.h"
 
 
+enum OmpKind { OMP_LOOP, OMP_BLOCK, OMP_STANDALONE };
+struct OmpDirective {
+	int pos = -1; // position of the sentinel in `global_code`
+	OmpKind kind = OMP_STANDALONE;
+	std::string construct; // fortran construct, e.g. `parallel do`
+	std::string pragma; // c++ construct, e.g. `parallel for`
+	std::string clauses;
+	int region_end = -1; // position of the matching `end` directive of a OMP_BLOCK, -1 lasts to the end of suite
+};
+
 struct TranslateContext {
 	std::string current_module;
 	std::map < std::string, CommonBlockInfo *> commonblocks;
@@ -34,8 +44,17 @@ struct TranslateContext {
 	std::map<std::string, std::vector<KeywordParamInfo>> func_kwargs;
 	ParseNode program_tree;
 	std::string global_code;
+	std::vector<int> line_start; // position of the start of every line of `global_code`, ref `get_source_line`
 	ParseConfig parse_config;
 	std::map<std::string, std::vector<std::string> > end_labels; // (lineno, blockname)
+	std::map<int, std::vector<OmpDirective> > omp_directives; // (position of the first token of the bound stmt, directives)
+	std::string omp_loop_pragma; // `#pragma omp for ...` waiting for the next NT_DORANGE
+	int omp_collapse = 0; // count of nested loops left to generate in canonical form
+	int autopar_depth = 0; // count of enclosing loops parallelized by `--autopar`
+	std::map<std::string, std::string> array_accessors; // (array, its `forrank` accessor hoisted out of the enclosing DO loop)
+	std::map<std::string, int> goto_refs; // (label, count of `goto`s to it which are not restructured), ref `get_goto_region`
+	int goto_restructured = 0; // count of `goto`s restructured in the current function
+	std::set<std::string> soa_types; // derived types whose arrays are stored as struct-of-arrays, ref `is_soa_type`
 	bool inited;
 
 	void reset_context();
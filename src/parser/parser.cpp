@@ -36,11 +36,21 @@ void TranslateContext::reset_context() {
 	labels.clear();
 	clear_variables();
 	clear_functions();
+	clear_types();
 	for(std::map<std::string, CommonBlockInfo *>::value_type & pr: get_context().commonblocks){
 		delete pr.second;
 		pr.second = nullptr;
 	}
 	get_context().commonblocks.clear();
+	omp_directives.clear();
+	omp_loop_pragma = "";
+	omp_collapse = 0;
+	autopar_depth = 0;
+	array_accessors.clear();
+	goto_refs.clear();
+	goto_restructured = 0;
+	line_start.clear();
+	soa_types = parse_config.soa_types;
 	func_kwargs = sysfunc_args;
 
 	// global
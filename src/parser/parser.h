@@ -19,6 +19,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <set>
 #include <iostream>
 #include "tokenizer.h"
 
@@ -213,6 +214,7 @@ struct ParseConfig {
 	* source code from file/stdin
 	***************/
 	bool hasfile = false;
+	std::string filename;
 	bool usefor = true;
 	bool usefarray = true;
 	/***************
@@ -221,6 +223,40 @@ struct ParseConfig {
 	* for90std::forwritefree(...)
 	***************/
 	bool full_quali = false;
+	/***************
+	* set true to emit `#line` directives before each generated stmt
+	* so that profilers and sanitizers report fortran source lines
+	***************/
+	bool line_directive = false;
+	/***************
+	* set true to translate `!$omp`/`c$omp` directives into `#pragma omp`
+	* otherwise they are kept as comments
+	***************/
+	bool openmp = false;
+	/***************
+	* set true to parallelize DO loops proven free of loop-carried dependences
+	* with `#pragma omp parallel for` if `openmp` is set, or the runtime's thread pool
+	***************/
+	bool autopar = false;
+	/***************
+	* kind of `real` without a kind selector, and of real literals without exponent letter `d`
+	* 4 is `float`, 8 is `double`, 16 is `long double`
+	***************/
+	int default_real_kind = 8;
+	/***************
+	* set true to access array dummy arguments in DO loops by `forrank_restrict`
+	* fortran forbids a modified dummy argument to overlap other arrays, which C++ compilers can't assume
+	***************/
+	bool restrict_dummies = false;
+	/***************
+	* derived types whose arrays are stored as struct-of-arrays, given by `--soa`
+	* ALSO REFER `TranslateContext::soa_types`
+	***************/
+	std::set<std::string> soa_types;
+	/***************
+	* set true to count calls and time of every procedure, ref `forprofile_registry`
+	***************/
+	bool instrument = false;
 };
 
 
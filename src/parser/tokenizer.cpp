@@ -44,6 +44,7 @@ void reset_tokenizer_context(){
 	get_tokenizer_context().terminal_cache.clear();
 	get_tokenizer_context().terminal_cache_line.clear();
 	get_tokenizer_context().comments.clear();
+	get_tokenizer_context().directives.clear();
 	get_tokenizer_context().load_code = [](const std::string & _code) {
 	};
 	get_tokenizer_context().unload_code = []() {
@@ -183,6 +184,22 @@ const vector<KeywordMeta> keywords = {
 		, TokenMeta::While
 		, YY_DOWHILE
 	}
+	, KeywordMeta{"doconcurrent"
+		, TokenMeta::Do
+		, YY_DOCONCURRENT
+	}
+	, KeywordMeta{"forall"
+		, TokenMeta::META_ANY
+		, YY_FORALL
+	}
+	, KeywordMeta{"endforall"
+		, TokenMeta::RBrace
+		, YY_ENDFORALL
+	}
+	, KeywordMeta{"elsewhere"
+		, TokenMeta::META_ANY
+		, YY_ELSEWHERE
+	}
 	, KeywordMeta{"exit"
 		, TokenMeta::META_ANY
 		, YY_EXIT
@@ -219,6 +236,14 @@ const vector<KeywordMeta> keywords = {
 		, TokenMeta::META_ANY
 		, YY_RECURSIVE
 	}
+	, KeywordMeta{"pure"
+		, TokenMeta::META_ANY
+		, YY_PURE
+	}
+	, KeywordMeta{"elemental"
+		, TokenMeta::META_ANY
+		, YY_ELEMENTAL
+	}
 	, KeywordMeta{"result"
 		, TokenMeta::META_ANY
 		, YY_RESULT
@@ -561,10 +586,10 @@ const vector<KeywordMeta> keywords = {
 
 
 const std::map<std::string, std::vector<std::string> > forward1 = {
-	{"else", {"if"}}
-	, {"do", { "while" }}
+	{"else", {"if", "where"}}
+	, {"do", { "while", "concurrent" }}
 	, { "go", { "to" } }
-	,{ "end",{ "if", "do", "function", "subroutine", "program", "select", "interface", "type"}}
+	,{ "end",{ "if", "do", "function", "subroutine", "program", "select", "interface", "type", "forall", "where"}}
 	,{ "double",{ "precision" } }
 
 };
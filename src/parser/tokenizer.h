@@ -51,6 +51,8 @@ struct TokenizerContext {
 	std::vector<std::tuple<int, Term>> terminal_cache_line;
 	// Cumulative comments
 	std::vector<std::string> comments;
+	// `!$omp` directives(position, text after the sentinel), only collected with `--openmp`
+	std::vector<std::tuple<int, std::string>> directives;
 	//
 	std::function<void(const std::string &)> load_code;
 	std::function<void()> unload_code;
@@ -55,23 +55,33 @@ void regen_print(FunctionInfo * finfo, ParseNode & stmt);
 std::string regen_vardef(FunctionInfo * finfo, VariableInfo * vinfo, std::string alias_name = "", bool save_to_node = true);
 std::string regen_vardef_array_initial_str(FunctionInfo * finfo, VariableInfo * vinfo, ParseNode & slice_node); // only called by regen_vardef
 std::string regen_vardef_scalar_initial_str(FunctionInfo * finfo, VariableInfo * vinfo); // only called by regen_vardef
+std::string gen_init_once(FunctionInfo * finfo, const std::string & name, const std::string & init_str);
+void regen_data(FunctionInfo * finfo, ParseNode & data_stmt);
 void regen_function(FunctionInfo * finfo, ParseNode & functiondecl_node);
 void regen_function_1(FunctionInfo * finfo, ParseNode & functiondecl_node);
 void regen_function_2(FunctionInfo * finfo);
 void regen_derived_type_1(TypeInfo* finfo, ParseNode& functiondecl_node);
 void regen_derived_type_2(TypeInfo* tinfo);
+std::string gen_soa_definition(TypeInfo * tinfo);
 void regen_select(FunctionInfo * finfo, ParseNode & select_stmt);
 void regen_if(FunctionInfo * finfo, ParseNode & if_stmt);
 void regen_elseif(FunctionInfo * finfo, ParseNode & elseif_stmt);
 void regen_do(FunctionInfo * finfo, ParseNode & do_stmt);
 void regen_do_range(FunctionInfo * finfo, ParseNode & do_stmt);
 void regen_do_while(FunctionInfo * finfo, ParseNode & do_stmt);
+void regen_do_concurrent(FunctionInfo * finfo, ParseNode & do_stmt);
+void regen_forall(FunctionInfo * finfo, ParseNode & forall_stmt);
 void regen_simple_stmt(FunctionInfo * finfo, ParseNode & stmt);
 void regen_all_variables(FunctionInfo * finfo, ParseNode & oldsuite);
 void regen_all_variables_decl_str(FunctionInfo * finfo, ParseNode & oldsuite);
 void regen_suite(FunctionInfo * finfo, ParseNode & oldsuite, bool is_partial = false);
 std::string regen_stmt(FunctionInfo * finfo, ParseNode & stmt);
+std::string gen_line_directive(const ParseNode & stmt);
+int get_source_pos(const ParseNode & stmt);
+int get_source_line(const ParseNode & stmt);
 void regen_arraybuilder(FunctionInfo * finfo, ParseNode & arraybuilder);
+std::string gen_arraybuilder_fill(FunctionInfo * finfo, VariableInfo * vinfo, const std::string & name, ParseNode & arraybuilder);
+bool regen_arraybuilder_assignment(FunctionInfo * finfo, ParseNode & stmt);
 void regen_common(FunctionInfo * finfo, ParseNode & common_block);
 void promote_type(ParseNode & type_nospec, VariableDesc & vardesc);
 void regen_exp(FunctionInfo * finfo, ParseNode & exp);
@@ -87,6 +97,9 @@ void regen_hiddendo_exprex(FunctionInfo * finfo, ParseNode & hiddendo, std::func
 
 // In-context functions
 SliceBoundInfo get_lbound_size_from_slice(FunctionInfo * finfo, ParseNode & dimen_slice);
+std::string gen_static_array_typestr(FunctionInfo * finfo, VariableInfo * vinfo, ParseNode & slice_node);
+std::string gen_static_dims_str(FunctionInfo * finfo, ParseNode & slice_node, long long & flatsize);
+std::string gen_auto_array_typestr(FunctionInfo * finfo, VariableInfo * vinfo, ParseNode & slice_node);
 SliceBoundInfo get_lbound_size_from_hiddendo(FunctionInfo * finfo, ParseNode & hiddendo, std::vector<ParseNode *> hiddendo_layer);
 SliceBoundInfo get_lbound_ubound_from_hiddendo(FunctionInfo * finfo, ParseNode & hiddendo, std::vector<ParseNode *> hiddendo_layer);
 std::vector<VariableInfo *> get_all_declared_vinfo(FunctionInfo * finfo, const ParseNode & suite);
@@ -94,8 +107,12 @@ std::vector<ParseNode *> get_all_declared_nodes(FunctionInfo * finfo, ParseNode
 VariableInfo * check_implicit_variable(FunctionInfo * finfo, const std::string & name);
 ParseNode gen_implicit_type(FunctionInfo * finfo, std::string name);
 ParseNode require_format_index(FunctionInfo * finfo, std::string format_index);
+std::string add_escape_char(std::string s);
 void get_full_paramtable(FunctionInfo * finfo);
 std::string gen_function_signature(FunctionInfo * finfo, int style = 0);
+void set_function_prefix(FunctionInfo * finfo, const ParseNode & functiondecl_node);
+std::string gen_function_attributes(FunctionInfo * finfo);
+std::string gen_profile_stmt(const std::string & procedure_name);
 std::vector<std::string> gen_func_alias_signature(FunctionInfo * finfo);
 std::string gen_paramtable_str(FunctionInfo * finfo, const std::vector<std::string> & paramtable_info, bool with_name = true);
 
@@ -131,10 +148,67 @@ VariableDesc & get_variabledesc_attr(ParseNode & vardescattr_node);
 ParseNode gen_type(const ParseNode & type_nospec, const ParseNode & _type_kind);
 ParseNode gen_type(const ParseNode & type_nospec);
 ParseNode gen_type(Term typeterm);
+Term gen_real_term(int kind);
+int get_real_kind(const ParseNode & type, const VariableDesc & vardesc);
+Term gen_real_literal_term(const std::string & number, int kind);
+ParseNode gen_real_literal(const std::string & lit);
 std::string gen_qualified_typestr(const ParseNode & type_spec, VariableDesc & vardesc, bool in_paramtable);
+bool is_arithmetic_type(const ParseNode & type_spec);
+bool is_soa_type(const std::string & type_name);
 
 // label
 void log_format_index(std::string format_index, const ParseNode & format);
+struct GotoRegion {
+	// stmts [begin, end) of a suite which are restructured into `head { [body_begin, body_end) } tail`
+	//	and `else { [else_begin, else_end) }` if `else_begin` is not -1
+	int end;
+	std::string head;
+	int body_begin, body_end;
+	int else_begin = -1, else_end = -1;
+	std::string tail;
+};
+int log_goto_refs(FunctionInfo * finfo, const ParseNode & suite);
+bool get_goto_region(FunctionInfo * finfo, ParseNode & suite, int begin, int end, GotoRegion & region);
+bool is_label_restructured(FunctionInfo * finfo, const std::string & label);
+std::string regen_computed_goto(FunctionInfo * finfo, ParseNode & goto_stmt);
+void report_goto(FunctionInfo * finfo, int gotos);
+
+// openmp
+struct OmpRegion {
+	int end_pos; // position of the `end` directive
+	std::string pragma;
+	std::string outer_code; // code of the enclosing suite before the region
+};
+void bind_omp_directives(const ParseNode & program);
+void regen_omp_directives(FunctionInfo * finfo, ParseNode & suite, int stmt_index, std::vector<OmpRegion> & regions, std::string & code);
+void close_omp_regions(std::vector<OmpRegion> & regions, std::string & code, int pos = -1);
+bool omp_clauses_mention(const std::string & pragma, const std::string & name);
+
+// autopar
+struct ParallelLoopInfo {
+	bool parallel = false;
+	std::string reason; // why the loop is not parallel
+	std::vector<std::string> private_names;
+	std::vector<std::string> lastprivate_names; // private, and read after the loop
+	std::vector<std::tuple<std::string, std::string>> reductions; // (operator, name)
+};
+ParallelLoopInfo analyze_do_range(FunctionInfo * finfo, const ParseNode & do_stmt, bool openmp);
+void report_autopar(const ParseNode & do_stmt, const ParallelLoopInfo & info);
+bool get_fixed_shape(VariableInfo * vinfo, std::string & shape);
+bool regen_scalarized_assignment(FunctionInfo * finfo, ParseNode & stmt);
+bool regen_inline_reduction(FunctionInfo * finfo, ParseNode & callable, const std::string & head_name);
+void regen_where(FunctionInfo * finfo, ParseNode & where);
+
+// constant folding
+struct ConstValue {
+	bool is_int;
+	long long i;
+	double d;
+	int kind = 8; // of a real, `float` values are rounded to `float`
+};
+bool eval_const_exp(FunctionInfo * finfo, const ParseNode & exp, ConstValue & value);
+std::string gen_const_literal(const ConstValue & value);
+bool regen_folded_exp(FunctionInfo * finfo, ParseNode & exp);
 
 // copyrights
 std::string gen_rights(std::string filename, std::string author);
@@ -142,6 +216,7 @@ ParseNode gen_header();
 
 // common
 ParseNode gen_common_definition(std::string common_name);
+std::string gen_common_view(FunctionInfo * finfo, VariableInfo * vinfo);
 ParseNode gen_common(const ParseNode & commonname_node, const ParseNode & paramtable);
 ParseNode gen_comment(std::string comment, bool line_comment = true);
 CommonBlockInfo * add_commonblock(std::string commonblock_name);
@@ -20,6 +20,7 @@
 #include "gen_common.h"
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <set>
 
 ParseNode gen_arraybuilder_from_paramtable(const ParseNode & argtable) {
 	/*****************
@@ -120,6 +121,234 @@ bool maybe_return_array(FunctionInfo * finfo, const ParseNode & elem) {
 	}
 }
 
+namespace {
+	// intrinsics which return an array from scalar arguments
+	const std::set<std::string> array_from_scalar_intrinsics = { "spread" };
+
+	bool is_scalar_fill_exp(FunctionInfo * finfo, const ParseNode & exp, const std::string & target, const std::set<std::string> & indexes) {
+		// returns true if `exp` is known to be a scalar which doesn't read `target`
+		if (exp.token_equals(TokenMeta::UnknownVariant) && exp.length() == 0)
+		{
+			if (exp.get_what() == target)
+			{
+				return false;
+			}
+			if (indexes.count(exp.get_what()))
+			{
+				return true;
+			}
+			VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, exp.get_what());
+			return vinfo == nullptr || !(vinfo->is_array() || (vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable)));
+		}
+		else if (exp.token_equals(TokenMeta::NT_FUCNTIONARRAY)) {
+			std::string name = exp.get(0).get_what();
+			if (name == target || array_from_scalar_intrinsics.count(name))
+			{
+				return false;
+			}
+			FunctionInfo * f = get_function(get_context().current_module, name);
+			if (f != nullptr)
+			{
+				VariableInfo * result_vinfo = get_variable(get_context().current_module, f->local_name, f->result_name);
+				if (f->is_subroutine() || result_vinfo == nullptr || result_vinfo->is_array())
+				{
+					return false;
+				}
+			}
+			// an element of an array, or a function of scalars
+			for (const ParseNode * arg : exp.get(1))
+			{
+				if (!is_scalar_fill_exp(finfo, *arg, target, indexes))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		else if (exp.token_equals(TokenMeta::NT_SLICE, TokenMeta::NT_VARIABLEINITIALDUMMY, TokenMeta::NT_HIDDENDO, TokenMeta::NT_ARRAYBUILDER_LIST)) {
+			return false;
+		}
+		for (const ParseNode * child : exp)
+		{
+			if (!is_scalar_fill_exp(finfo, *child, target, indexes))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool is_fill_item(FunctionInfo * finfo, const ParseNode & item, const std::string & target, std::set<std::string> indexes) {
+		if (item.token_equals(TokenMeta::NT_HIDDENDO))
+		{
+			if (!is_scalar_fill_exp(finfo, item.get(2), target, indexes) || !is_scalar_fill_exp(finfo, item.get(3), target, indexes))
+			{
+				return false;
+			}
+			indexes.insert(item.get(1).get_what());
+			for (const ParseNode * p : item.get(0))
+			{
+				if (!is_fill_item(finfo, *p, target, indexes))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		return is_scalar_fill_exp(finfo, item, target, indexes);
+	}
+
+	std::string gen_fill_item(FunctionInfo * finfo, ParseNode & item, const std::string & flat, const std::string & k) {
+		if (item.token_equals(TokenMeta::NT_HIDDENDO))
+		{
+			ParseNode & index = item.get(1);
+			ParseNode & from = item.get(2);
+			ParseNode & to = item.get(3);
+			regen_exp(finfo, from);
+			regen_exp(finfo, to);
+			std::string body = make_str_list(item.get(0).begin(), item.get(0).end(), [&](ParseNode * p) {
+				return gen_fill_item(finfo, *p, flat, k);
+			}, "");
+			sprintf(codegen_buf, "for(fsize_t %s = %s; %s <= %s; %s++){\n%s}\n", index.get_what().c_str(), from.get_what().c_str()
+				, index.get_what().c_str(), to.get_what().c_str(), index.get_what().c_str(), tabber(body).c_str());
+		}
+		else {
+			regen_exp(finfo, item);
+			sprintf(codegen_buf, "%s[%s++] = %s;\n", flat.c_str(), k.c_str(), item.get_what().c_str());
+		}
+		return string(codegen_buf);
+	}
+
+	bool gen_fill_table(FunctionInfo * finfo, VariableInfo * vinfo, const ParseNode & argtable, std::string & table) {
+		// a constructor of constants whose count is the size of the array is a table of the element type
+		int kind = 0;
+		bool is_int_type = vinfo->type.token_equals(TokenMeta::Int_Decl) || (is_int(vinfo->type) && !vinfo->type.token_equals(TokenMeta::Char));
+		if (!is_int_type && ((kind = get_real_kind(vinfo->type, vinfo->desc)) == 0 || kind > 8))
+		{
+			return false;
+		}
+		std::string shape;
+		if (!get_fixed_shape(vinfo, shape))
+		{
+			return false;
+		}
+		std::vector<std::string> extents;
+		boost::split(extents, shape, boost::is_any_of(", "), boost::token_compress_on);
+		long long size = 1;
+		for (const std::string & extent : extents)
+		{
+			if (extent.empty() || extent.find_first_not_of("0123456789") != std::string::npos)
+			{
+				return false;
+			}
+			size *= std::atoll(extent.c_str());
+		}
+		if (size != (long long)argtable.length())
+		{
+			return false;
+		}
+		table = "";
+		for (const ParseNode * p : argtable)
+		{
+			ConstValue value;
+			if (!eval_const_exp(finfo, *p, value))
+			{
+				return false;
+			}
+			if (is_int_type)
+			{
+				// as the conversion of assignment
+				long long i = value.is_int ? value.i : (long long)value.d;
+				value = ConstValue{ true, i, (double)i };
+			}
+			else {
+				value = ConstValue{ false, 0, value.is_int ? (double)value.i : value.d, kind };
+			}
+			table += (table.empty() ? "" : ", ") + gen_const_literal(value);
+		}
+		return true;
+	}
+}
+
+std::string gen_arraybuilder_fill(FunctionInfo * finfo, VariableInfo * vinfo, const std::string & name, ParseNode & array_builder) {
+	/**************************************
+	* fill the array `name` in place from an `(/ /)` constructor of scalars and implied-do,
+	*	rather than making a `farray` by `make_init_list` and `forconcat` and copying it to `name`
+	* returns "" if the constructor can't be filled in place
+	* e.g. `a = (/ 0, (i * 2, i = 1, n) /)`
+	*	```
+	*	{
+	*		auto a_flat = a.begin();
+	*		fsize_t a_k = 0;
+	*		a_flat[a_k++] = 0;
+	*		for(fsize_t i = 1; i <= n; i++){
+	*			a_flat[a_k++] = i * 2;
+	*		}
+	*	}
+	*	```
+	* a constructor of constants which has the size of `name` is copied from a `static const` table
+	*	`static const int a_init[] = {1, 2, 3};`
+	***************************************/
+	if (!array_builder.token_equals(TokenMeta::NT_ARRAYBUILDER_LIST) || vinfo->desc.allocatable.get() || vinfo->desc.pointer.get())
+	{
+		return "";
+	}
+	ParseNode & argtable = array_builder.get(0);
+	for (const ParseNode * p : argtable)
+	{
+		if (!is_fill_item(finfo, *p, vinfo->local_name, {}))
+		{
+			return "";
+		}
+	}
+	std::string code;
+	std::string table;
+	if (gen_fill_table(finfo, vinfo, argtable, table))
+	{
+		sprintf(codegen_buf, "static const %s %s_init[] = {%s};\nstd::copy_n(%s_init, %d, %s.begin());\n", vinfo->type.get_what().c_str(), vinfo->local_name.c_str()
+			, table.c_str(), vinfo->local_name.c_str(), argtable.length(), name.c_str());
+		code = string(codegen_buf);
+	}
+	else {
+		std::string flat = vinfo->local_name + "_flat";
+		std::string k = vinfo->local_name + "_k";
+		code = "auto " + flat + " = " + name + ".begin();\nfsize_t " + k + " = 0;\n";
+		for (ParseNode * p : argtable)
+		{
+			code += gen_fill_item(finfo, *p, flat, k);
+		}
+	}
+	array_builder.get_what() = "{\n" + tabber(code) + "}";
+	return array_builder.get_what();
+}
+
+bool regen_arraybuilder_assignment(FunctionInfo * finfo, ParseNode & stmt) {
+	/****************
+	* `stmt` is an assignment of an array constructor to a whole array, which is not regenerated
+	* returns false if it is not filled in place, ref `gen_arraybuilder_fill`
+	****************/
+	ParseNode & exp = stmt.get(0);
+	if (!(exp.token_equals(TokenMeta::NT_EXPRESSION) && exp.length() == 3 && exp.get(2).token_equals(TokenMeta::Let)
+		&& exp.get(0).token_equals(TokenMeta::UnknownVariant) && exp.get(0).length() == 0 && exp.get(1).token_equals(TokenMeta::NT_ARRAYBUILDER_LIST)))
+	{
+		return false;
+	}
+	ParseNode & lhs = exp.get(0);
+	VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, lhs.get_what());
+	if (vinfo == nullptr || !(vinfo->is_array() || (vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable))))
+	{
+		return false;
+	}
+	regen_exp(finfo, lhs);
+	std::string code = gen_arraybuilder_fill(finfo, vinfo, lhs.get_what(), exp.get(1));
+	if (code == "")
+	{
+		return false;
+	}
+	stmt.get_what() = code;
+	return true;
+}
+
 void regen_arraybuilder(FunctionInfo * finfo, ParseNode & array_builder) {
 	// wrap arraybuilder.fs.CurrentTerm.what with make_farray function
 	string arr_decl;
@@ -132,7 +361,16 @@ void regen_arraybuilder(FunctionInfo * finfo, ParseNode & array_builder) {
 		concat_array = std::accumulate(argtable.begin(), argtable.end(), false, [&](bool x, ParseNode * p) {
 			return x || maybe_return_array(finfo, *p);
 		});
-        if(array_builder.father->father->token_equals(TokenMeta::NT_VARIABLEDEFINE))
+		// an array builder of an assignment in the main program has less ancestors
+		auto ancestor = [&](int n) {
+			ParseNode * pn = &array_builder;
+			for (int i = 0; i < n && pn != nullptr; i++)
+			{
+				pn = pn->father;
+			}
+			return pn;
+		};
+        if(ancestor(2) != nullptr && ancestor(2)->token_equals(TokenMeta::NT_VARIABLEDEFINE))
         {
             if(array_builder.father->father->get(0).get_what()=="double")
             {
@@ -152,7 +390,7 @@ void regen_arraybuilder(FunctionInfo * finfo, ParseNode & array_builder) {
                 }
                 argtable.get_what().pop_back();
             }
-        }else if(array_builder.father->father->father->father->token_equals(TokenMeta::NT_VARIABLEDEFINE))
+        }else if(ancestor(4) != nullptr && ancestor(4)->token_equals(TokenMeta::NT_VARIABLEDEFINE))
         {
             if(array_builder.father->father->father->father->get(0).get_what()=="double")
             {
@@ -183,7 +421,7 @@ void regen_arraybuilder(FunctionInfo * finfo, ParseNode & array_builder) {
 		{
 			// all elements in the array builder is scalar
 			// can init array from initializer_list of initial value
-            if(array_builder.father->father->get(0).get_what()=="reshape") sprintf(codegen_buf, "{%s}", argtable.get_what().c_str());
+            if(ancestor(2) != nullptr && ancestor(2)->length() > 0 && ancestor(2)->get(0).get_what()=="reshape") sprintf(codegen_buf, "{%s}", argtable.get_what().c_str());
             else if(argtable.child.size()>1) sprintf(codegen_buf, "make_init_list({%s})", argtable.get_what().c_str());
             else sprintf(codegen_buf, "make_init_list(%s)", argtable.get_what().c_str());
 			arr_decl = string(codegen_buf);
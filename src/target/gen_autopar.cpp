@@ -0,0 +1,560 @@
+/*
+*   Calvin Neo
+*   Copyright (C) 2016  Calvin Neo <calvinneo@calvinneo.com>
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License along
+*   with this program; if not, write to the Free Software Foundation, Inc.,
+*   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "gen_common.h"
+#include <set>
+
+/**************************************
+* dependence analysis of `do i = a, b, c` loops, used by `--autopar`
+*	a loop is parallel when
+*	1. the body has only assignments, `if` blocks and inner DO loops, and calls only pure intrinsics
+*	2. every scalar written in the body is defined before it is read in the same iteration
+*		(it is private), or only accumulates `s = s op e`(it is a reduction),
+*		which must be the only statement of the body mentioning `s`
+*	3. every reference to a written array has the same subscripts, one of which is
+*		`c1 * i + c0` with loop invariant `c0` and nonzero literal `c1`,
+*		so different iterations write different elements, and read only what they write
+*	4. no array written is a `pointer` or `target`, or a dummy argument which may be associated with
+*		another array of the body, unless `--restrict`
+*	the bounds must not be written by the body either
+*	the parse tree is analysed before it is regenerated
+***************************************/
+
+namespace {
+	const std::set<std::string> pure_intrinsics = {
+		"abs", "acos", "asin", "atan", "atan2", "cos", "cosh", "exp", "log", "log10", "sin", "sinh", "sqrt", "tan", "tanh"
+		, "max", "min", "mod", "sign", "real", "dble", "float", "int", "nint", "aimag", "conjg", "cmplx"
+	};
+
+	struct ArrayRef {
+		std::string name;
+		const ParseNode * args; // nullptr for the whole array
+		bool is_write;
+	};
+
+	struct LoopScan {
+		FunctionInfo * finfo;
+		std::string var;
+		std::set<std::string> inner_vars;
+		std::set<std::string> written_scalars;
+		std::set<std::string> written_arrays;
+		std::vector<ArrayRef> refs;
+		std::map<std::string, std::string> reduction_ops; // candidates, "" if disproved
+		std::map<std::string, int> scalar_assigns;
+		std::set<std::string> exposed_reads; // scalars read before defined in an iteration
+		std::set<std::string> reduction_self_reads;
+		std::string reason;
+
+		void reject(const std::string & why) {
+			if (reason.empty())
+			{
+				reason = why;
+			}
+		}
+	};
+
+	bool is_array_name(FunctionInfo * finfo, const std::string & name) {
+		VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, name);
+		// `real a(10)` keeps its shape in the entity until it is generated
+		return vinfo != nullptr && (vinfo->is_array() || (vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable)));
+	}
+
+	bool may_be_pointed(FunctionInfo * finfo, const std::string & name) {
+		// memory of the array may be reached through another name
+		VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, name);
+		return vinfo != nullptr && (vinfo->desc.pointer || vinfo->desc.target || !vinfo->commonblock_name.empty());
+	}
+
+	bool is_dummy_argument(FunctionInfo * finfo, const std::string & name) {
+		const std::vector<std::string> & params = finfo->funcdesc.paramtable_info;
+		return std::find(params.begin(), params.end(), name) != params.end();
+	}
+
+	bool is_assignment(const ParseNode & stmt) {
+		return stmt.token_equals(TokenMeta::NT_STATEMENT) && stmt.length() > 0
+			&& stmt.get(0).token_equals(TokenMeta::NT_EXPRESSION) && stmt.get(0).length() == 3
+			&& stmt.get(0).get(2).token_equals(TokenMeta::Let) && stmt.get(0).get(2).get_what() == "%s = %s";
+	}
+
+	bool is_name(const ParseNode & x) {
+		return x.length() == 0 && x.token_equals(TokenMeta::UnknownVariant, TokenMeta::META_WORD);
+	}
+
+	std::string node_key(const ParseNode & x) {
+		if (x.length() == 0)
+		{
+			return x.get_what();
+		}
+		std::string key = "(" + std::to_string(x.get_token());
+		for (const ParseNode * child : x)
+		{
+			key += " " + node_key(*child);
+		}
+		return key + ")";
+	}
+
+	void get_names(const ParseNode & x, std::vector<std::string> & names) {
+		if (is_name(x))
+		{
+			names.push_back(x.get_what());
+		}
+		for (const ParseNode * child : x)
+		{
+			get_names(*child, names);
+		}
+	}
+
+	void prescan_writes(LoopScan & scan, const ParseNode & node) {
+		// collect what the body writes, before checking the reads
+		if (is_assignment(node))
+		{
+			const ParseNode & lhs = node.get(0).get(0);
+			if (is_name(lhs))
+			{
+				(is_array_name(scan.finfo, lhs.get_what()) ? scan.written_arrays : scan.written_scalars).insert(lhs.get_what());
+			}
+			else if (lhs.token_equals(TokenMeta::NT_FUCNTIONARRAY) && lhs.length() > 0 && is_name(lhs.get(0)))
+			{
+				scan.written_arrays.insert(lhs.get(0).get_what());
+			}
+		}
+		else if (node.token_equals(TokenMeta::NT_DORANGE))
+		{
+			scan.inner_vars.insert(node.get(0).get_what());
+			scan.written_scalars.insert(node.get(0).get_what());
+		}
+		for (const ParseNode * child : node)
+		{
+			prescan_writes(scan, *child);
+		}
+	}
+
+	bool is_invariant(const LoopScan & scan, const ParseNode & x) {
+		std::vector<std::string> names;
+		get_names(x, names);
+		for (const std::string & name : names)
+		{
+			if (name == scan.var || scan.written_scalars.count(name) || scan.written_arrays.count(name))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool is_injective_subscript(const LoopScan & scan, const ParseNode & x) {
+		// `i`, `i + c`, `c - i`, `k * i`...
+		if (is_name(x))
+		{
+			return x.get_what() == scan.var;
+		}
+		if (x.token_equals(TokenMeta::NT_EXPRESSION) && x.length() == 3)
+		{
+			const ParseNode & op = x.get(2);
+			const ParseNode & a = x.get(0);
+			const ParseNode & b = x.get(1);
+			if (op.token_equals(TokenMeta::Add, TokenMeta::Minus))
+			{
+				return (is_injective_subscript(scan, a) && is_invariant(scan, b))
+					|| (is_injective_subscript(scan, b) && is_invariant(scan, a));
+			}
+			if (op.token_equals(TokenMeta::Multiply))
+			{
+				return (is_injective_subscript(scan, a) && is_int(b) && b.get_what() != "0")
+					|| (is_injective_subscript(scan, b) && is_int(a) && a.get_what() != "0");
+			}
+		}
+		return false;
+	}
+
+	void scan_exp(LoopScan & scan, const ParseNode & x, const std::set<std::string> & defined) {
+		if (is_name(x))
+		{
+			const std::string & name = x.get_what();
+			if (is_array_name(scan.finfo, name))
+			{
+				scan.refs.push_back(ArrayRef{ name, nullptr, false });
+			}
+			else if (scan.written_scalars.count(name) && !defined.count(name) && name != scan.var)
+			{
+				scan.exposed_reads.insert(name);
+			}
+			return;
+		}
+		if (x.token_equals(TokenMeta::NT_FUCNTIONARRAY) && x.length() > 0 && is_name(x.get(0)))
+		{
+			const std::string & name = x.get(0).get_what();
+			if (is_array_name(scan.finfo, name))
+			{
+				scan.refs.push_back(ArrayRef{ name, x.length() > 1 ? &x.get(1) : nullptr, false });
+			}
+			else if (!pure_intrinsics.count(name)) {
+				scan.reject("calls `" + name + "`");
+			}
+			for (int i = 1; i < x.length(); i++)
+			{
+				scan_exp(scan, x.get(i), defined);
+			}
+			return;
+		}
+		for (const ParseNode * child : x)
+		{
+			scan_exp(scan, *child, defined);
+		}
+	}
+
+	std::string get_reduction_op(const std::string & name, const ParseNode & rhs) {
+		/**************************************
+		* `s = s + e`, `s = e * s`, `s = s - e`, `s = max(s, e)`
+		*	where `e` does not read `s`
+		***************************************/
+		auto reads = [&](const ParseNode & e) {
+			std::vector<std::string> names;
+			get_names(e, names);
+			return std::find(names.begin(), names.end(), name) != names.end();
+		};
+		if (rhs.token_equals(TokenMeta::NT_EXPRESSION) && rhs.length() == 3)
+		{
+			const ParseNode & a = rhs.get(0);
+			const ParseNode & b = rhs.get(1);
+			const ParseNode & op = rhs.get(2);
+			bool self_first = is_name(a) && a.get_what() == name && !reads(b);
+			bool self_second = is_name(b) && b.get_what() == name && !reads(a);
+			if (op.token_equals(TokenMeta::Add) && (self_first || self_second))
+			{
+				return "+";
+			}
+			if (op.token_equals(TokenMeta::Minus) && self_first)
+			{
+				return "+";
+			}
+			if (op.token_equals(TokenMeta::Multiply) && (self_first || self_second))
+			{
+				return "*";
+			}
+		}
+		if (rhs.token_equals(TokenMeta::NT_FUCNTIONARRAY) && rhs.length() == 2 && is_name(rhs.get(0))
+			&& (rhs.get(0).get_what() == "max" || rhs.get(0).get_what() == "min") && rhs.get(1).length() == 2)
+		{
+			const ParseNode & a = rhs.get(1).get(0);
+			const ParseNode & b = rhs.get(1).get(1);
+			if ((is_name(a) && a.get_what() == name && !reads(b)) || (is_name(b) && b.get_what() == name && !reads(a)))
+			{
+				return rhs.get(0).get_what();
+			}
+		}
+		return "";
+	}
+
+	void scan_suite(LoopScan & scan, const ParseNode & suite, std::set<std::string> & defined);
+
+	void scan_stmt(LoopScan & scan, const ParseNode & stmt, std::set<std::string> & defined) {
+		if (!scan.reason.empty())
+		{
+			return;
+		}
+		if (is_assignment(stmt))
+		{
+			const ParseNode & lhs = stmt.get(0).get(0);
+			const ParseNode & rhs = stmt.get(0).get(1);
+			if (is_name(lhs) && !is_array_name(scan.finfo, lhs.get_what()))
+			{
+				const std::string & name = lhs.get_what();
+				if (name == scan.var || scan.inner_vars.count(name))
+				{
+					scan.reject("assigns to DO variable `" + name + "`");
+					return;
+				}
+				std::string op = get_reduction_op(name, rhs);
+				scan.scalar_assigns[name]++;
+				auto iter = scan.reduction_ops.find(name);
+				if (iter == scan.reduction_ops.end())
+				{
+					scan.reduction_ops[name] = op;
+				}
+				else if (iter->second != op) {
+					iter->second = "";
+				}
+				if (!op.empty())
+				{
+					// the read of `s` in `s = s + e` belongs to the reduction
+					std::set<std::string> with_self = defined;
+					with_self.insert(name);
+					scan_exp(scan, rhs, with_self);
+					if (!defined.count(name))
+					{
+						scan.reduction_self_reads.insert(name);
+					}
+				}
+				else {
+					scan_exp(scan, rhs, defined);
+				}
+				defined.insert(name);
+			}
+			else if (lhs.token_equals(TokenMeta::NT_FUCNTIONARRAY) && lhs.length() > 0 && is_name(lhs.get(0))
+				&& is_array_name(scan.finfo, lhs.get(0).get_what())) {
+				if (lhs.length() < 2 || !lhs.get(1).token_equals(TokenMeta::NT_ARGTABLE_PURE))
+				{
+					scan.reject("assigns an array section of `" + lhs.get(0).get_what() + "`");
+					return;
+				}
+				scan_exp(scan, rhs, defined);
+				scan_exp(scan, lhs.get(1), defined);
+				scan.refs.push_back(ArrayRef{ lhs.get(0).get_what(), &lhs.get(1), true });
+			}
+			else {
+				scan.reject("assigns to a whole array or an unsupported target");
+			}
+		}
+		else if (stmt.token_equals(TokenMeta::NT_DORANGE)) {
+			for (int i = 1; i < 4; i++)
+			{
+				scan_exp(scan, stmt.get(i), defined);
+			}
+			// the body may run zero times, so definitions inside do not survive it
+			std::set<std::string> inner_defined = defined;
+			inner_defined.insert(stmt.get(0).get_what());
+			scan_suite(scan, stmt.get(4), inner_defined);
+			defined.insert(stmt.get(0).get_what());
+		}
+		else if (stmt.token_equals(TokenMeta::NT_IF, TokenMeta::NT_ELSEIF)) {
+			scan_exp(scan, stmt.get(0), defined);
+			for (int i = 1; i < stmt.length(); i++)
+			{
+				// only one branch runs, so definitions inside do not survive the `if`
+				std::set<std::string> branch_defined = defined;
+				if (stmt.get(i).token_equals(TokenMeta::NT_ELSEIF))
+				{
+					scan_stmt(scan, stmt.get(i), branch_defined);
+				}
+				else {
+					scan_suite(scan, stmt.get(i), branch_defined);
+				}
+			}
+		}
+		else if (stmt.token_equals(TokenMeta::NT_SUITE)) {
+			scan_suite(scan, stmt, defined);
+		}
+		else if (stmt.token_equals(TokenMeta::NT_DUMMY) || (stmt.token_equals(TokenMeta::NT_STATEMENT) && stmt.length() == 0)) {
+			// empty line
+		}
+		else if (stmt.token_equals(TokenMeta::NT_STATEMENT)) {
+			scan.reject("has a call or an expression statement");
+		}
+		else if (stmt.token_equals(TokenMeta::NT_CONTROL_STMT)) {
+			scan.reject("has a jump or stop statement");
+		}
+		else if (stmt.token_equals(TokenMeta::Label)) {
+			scan.reject("has a labeled statement");
+		}
+		else {
+			scan.reject("has a " + get_intent_name(stmt.get_token()) + " statement");
+		}
+	}
+
+	void scan_suite(LoopScan & scan, const ParseNode & suite, std::set<std::string> & defined) {
+		for (const ParseNode * stmt : suite)
+		{
+			scan_stmt(scan, *stmt, defined);
+		}
+	}
+
+	bool is_read_outside(const ParseNode & node, const ParseNode & loop, const std::string & name) {
+		// whether `name` is read by the function outside `loop`, so the value it has after `loop` matters
+		if (&node == &loop || node.token_equals(TokenMeta::NT_VARIABLEDEFINE, TokenMeta::NT_VARIABLEDEFINESET))
+		{
+			return false;
+		}
+		if (is_name(node))
+		{
+			return node.get_what() == name;
+		}
+		if (is_assignment(node) && is_name(node.get(0).get(0)) && node.get(0).get(0).get_what() == name)
+		{
+			return is_read_outside(node.get(0).get(1), loop, name);
+		}
+		bool redefined = node.token_equals(TokenMeta::NT_DORANGE) && node.get(0).get_what() == name;
+		for (int i = 0; i < node.length(); i++)
+		{
+			if (node.token_equals(TokenMeta::NT_DORANGE) && (i == 0 || (redefined && i == 4)))
+			{
+				continue; // assigned by the loop, and read inside the loop
+			}
+			if (is_read_outside(node.get(i), loop, name))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+ParallelLoopInfo analyze_do_range(FunctionInfo * finfo, const ParseNode & do_stmt, bool openmp) {
+	ParallelLoopInfo info;
+	LoopScan scan;
+	scan.finfo = finfo;
+	scan.var = do_stmt.get(0).get_what();
+	const ParseNode & suite = do_stmt.get(4);
+	prescan_writes(scan, suite);
+	for (int i = 1; i < 4; i++)
+	{
+		if (!is_invariant(scan, do_stmt.get(i)))
+		{
+			info.reason = "bounds are written by the body";
+			return info;
+		}
+		std::set<std::string> none;
+		scan_exp(scan, do_stmt.get(i), none);
+	}
+	if (!scan.reason.empty())
+	{
+		info.reason = "bounds " + scan.reason;
+		return info;
+	}
+	std::set<std::string> defined;
+	scan_suite(scan, suite, defined);
+	if (!scan.reason.empty())
+	{
+		info.reason = scan.reason;
+		return info;
+	}
+	// scalars
+	std::vector<std::string> body_names;
+	get_names(suite, body_names);
+	for (const std::string & name : scan.written_scalars)
+	{
+		auto iter = scan.reduction_ops.find(name);
+		// `s = s + e` mentions `s` twice, any other mention sees a partial value, like `a(i) = s` in a prefix sum
+		bool reduction = iter != scan.reduction_ops.end() && !iter->second.empty() && !scan.exposed_reads.count(name)
+			&& scan.scalar_assigns[name] == 1 && std::count(body_names.begin(), body_names.end(), name) == 2;
+		if (reduction)
+		{
+			info.reductions.push_back(std::make_tuple(iter->second, name));
+			continue;
+		}
+		if (scan.exposed_reads.count(name) || scan.reduction_self_reads.count(name))
+		{
+			info.reason = "scalar `" + name + "` is carried across iterations";
+			return info;
+		}
+		// the root of the tree is the function
+		const ParseNode * root = &do_stmt;
+		while (root->father != nullptr)
+		{
+			root = root->father;
+		}
+		if (is_read_outside(*root, do_stmt, name))
+		{
+			if (!openmp)
+			{
+				info.reason = "scalar `" + name + "` is used after the loop";
+				return info;
+			}
+			info.lastprivate_names.push_back(name);
+		}
+		else {
+			info.private_names.push_back(name);
+		}
+	}
+	if (!openmp && info.reductions.size() > 1)
+	{
+		info.reason = "more than one reduction needs --openmp";
+		return info;
+	}
+	// arrays
+	for (const std::string & name : scan.written_arrays)
+	{
+		const ArrayRef * write = nullptr;
+		for (const ArrayRef & ref : scan.refs)
+		{
+			if (ref.name != name)
+			{
+				continue;
+			}
+			if (ref.args == nullptr)
+			{
+				info.reason = "array `" + name + "` is written and used as a whole";
+				return info;
+			}
+			if (write == nullptr && ref.is_write)
+			{
+				write = &ref;
+			}
+		}
+		if (write == nullptr)
+		{
+			continue;
+		}
+		VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, name);
+		if (vinfo != nullptr && (vinfo->desc.pointer || vinfo->desc.target))
+		{
+			info.reason = "array `" + name + "` is a pointer or target, which may be aliased";
+			return info;
+		}
+		if (is_dummy_argument(finfo, name) && !get_context().parse_config.restrict_dummies)
+		{
+			// two dummy arguments may be passed the same array, and a pointer may point to the actual argument
+			for (const ArrayRef & ref : scan.refs)
+			{
+				if (ref.name != name && (is_dummy_argument(finfo, ref.name) || may_be_pointed(finfo, ref.name)))
+				{
+					info.reason = "dummy argument `" + name + "` may be associated with `" + ref.name + "`";
+					return info;
+				}
+			}
+		}
+		bool injective = false;
+		for (const ParseNode * subscript : *write->args)
+		{
+			injective = injective || is_injective_subscript(scan, *subscript);
+		}
+		if (!injective)
+		{
+			info.reason = "subscripts of `" + name + "` may repeat across iterations of `" + scan.var + "`";
+			return info;
+		}
+		std::string key = node_key(*write->args);
+		for (const ArrayRef & ref : scan.refs)
+		{
+			if (ref.name == name && node_key(*ref.args) != key)
+			{
+				info.reason = "array `" + name + "` is referenced with different subscripts";
+				return info;
+			}
+		}
+	}
+	info.parallel = true;
+	return info;
+}
+
+void report_autopar(const ParseNode & do_stmt, const ParallelLoopInfo & info) {
+	std::string what;
+	if (info.parallel)
+	{
+		what = "parallelized";
+		for (const std::tuple<std::string, std::string> & r : info.reductions)
+		{
+			what += ", reduction(" + std::get<0>(r) + ":" + std::get<1>(r) + ")";
+		}
+	}
+	else {
+		what = "not parallelized: " + info.reason;
+	}
+	fprintf(stderr, "Autopar : line %d, DO %s %s\n", get_source_line(do_stmt), do_stmt.get(0).get_what().c_str(), what.c_str());
+}
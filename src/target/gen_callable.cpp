@@ -36,13 +36,75 @@ std::string get_mapped_function_name(std::string origin_name) {
 	}
 }
 
+static bool regen_real_conversion(FunctionInfo * finfo, ParseNode & callable) {
+	/***********
+	* REAL(A [, KIND]), DBLE(A), SNGL(A), FLOAT(A)
+	*	convert to the type of the kind, ref `gen_real_term`
+	*	NOTICE `real` is already `double` after `pre_map`
+	***********/
+	string name = callable.get(0).to_string();
+	ParseNode & argtable = callable.get(1);
+	int kind;
+	if (name == "double" || name == "float") {
+		kind = 0;
+	}
+	else if (name == "dble") {
+		kind = 8;
+	}
+	else if (name == "sngl") {
+		kind = 4;
+	}
+	else {
+		return false;
+	}
+	if (get_function(get_context().current_module, name) != nullptr || get_variable(get_context().current_module, finfo->local_name, name) != nullptr
+		|| argtable.length() < 1 || argtable.length() > 2)
+	{
+		return false;
+	}
+	std::vector<ParseNode *> args;
+	for (ParseNode * elem : argtable)
+	{
+		if (elem->token_equals(TokenMeta::NT_KEYVALUE))
+		{
+			if (!elem->get(1).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY) && elem->get(0).to_string() != "kind")
+			{
+				return false;
+			}
+			args.push_back(elem->get(1).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY) ? &elem->get(0) : &elem->get(1));
+		}
+		else {
+			args.push_back(elem);
+		}
+	}
+	if (args.size() == 2)
+	{
+		ConstValue kind_value;
+		if (name != "double" || !eval_const_exp(finfo, *args[1], kind_value) || !kind_value.is_int)
+		{
+			return false;
+		}
+		kind = (int)kind_value.i;
+	}
+	regen_exp(finfo, *args[0]);
+	Term term = gen_real_term(kind);
+	string cast_name = term.token == TokenMeta::Float ? "to_float" : (term.token == TokenMeta::Double ? "to_double" : "to_longdouble");
+	callable.fs.CurrentTerm = Term{ TokenMeta::NT_FUCNTIONARRAY, cast_name + "(" + args[0]->get_what() + ")" };
+	return true;
+}
+
 void regen_function_array(FunctionInfo * finfo, ParseNode & callable) {
 
 	// function call OR array index 
 	// NOTE that array index can be A(1:2, 3:4) 
 	ParseNode & callable_head = callable.get(0);
 	ParseNode & argtable = callable.get(1);
-	string head_name = get_mapped_function_name(callable_head.to_string());
+	if (argtable.token_equals(TokenMeta::NT_ARGTABLE_PURE, TokenMeta::NT_PARAMTABLE_PURE) && regen_real_conversion(finfo, callable))
+	{
+		return;
+	}
+	// an array named like an intrinsic, e.g. `count(i)`, is not mapped
+	string head_name = get_variable(get_context().current_module, finfo->local_name, callable_head.to_string()) != nullptr ? callable_head.to_string() : get_mapped_function_name(callable_head.to_string());
 	bool is_sysfunc = sysfunc_args.find(head_name) != sysfunc_args.end();
 	if (argtable.token_equals(TokenMeta::NT_DIMENSLICE)) {
 		// array section
@@ -60,8 +122,9 @@ void regen_function_array(FunctionInfo * finfo, ParseNode & callable) {
 				string res = "{" + slice.get_what() + "}";
 				return res;
 			});
-            if(callable.father!= nullptr&&callable.father->child.size()==3&&callable.father->get(2).token_equals(TokenMeta::Let))
-            {   /* if part of e.g., a(i,1:9) = (/one,zero,zero, zero,one,zero, zero,zero,one/)
+            if(callable.father!= nullptr&&callable.father->child.size()==3&&callable.father->get(2).token_equals(TokenMeta::Let)
+                && &callable.father->get(0)==&callable)
+            {   /* if the left side of e.g., a(i,1:9) = (/one,zero,zero, zero,one,zero, zero,zero,one/)
                  * use assign_forslice to modify original array instead of copy
                  */
                 sprintf(codegen_buf, "assign_forslice(%%s, %%s, {%s})", slice_info_str.c_str());
@@ -105,6 +168,22 @@ void regen_function_array(FunctionInfo * finfo, ParseNode & callable) {
 			}
 		}
 		string argtable_str;
+		std::map<std::string, std::string>::iterator accessor = get_context().array_accessors.find(head_name);
+		if (accessor != get_context().array_accessors.end())
+		{
+			// an element of an array whose accessor is declared before the enclosing DO loop, ref `get_rank_accessors`
+			for (ParseNode * elem : argtable)
+			{
+				ParseNode & index = elem->token_equals(TokenMeta::NT_KEYVALUE) ? elem->get(0) : *elem;
+				regen_exp(finfo, index);
+			}
+			argtable_str = make_str_list(argtable.begin(), argtable.end(), [&](ParseNode * elem) {
+				return (elem->token_equals(TokenMeta::NT_KEYVALUE) ? elem->get(0) : *elem).get_what();
+			});
+			sprintf(codegen_buf, "%s(%s)", accessor->second.c_str(), argtable_str.c_str());
+			callable.fs.CurrentTerm = Term{ TokenMeta::NT_FUCNTIONARRAY, string(codegen_buf) };
+			return;
+		}
 		/**************
 		* If a function have keyword parameters, it should logged in `get_context().func_kwargs`
 		* `get_context().func_kwargs` records every keyword paramters' information
@@ -122,6 +201,25 @@ void regen_function_array(FunctionInfo * finfo, ParseNode & callable) {
 		int normal_count = 0; 
 		map<string, string> kw_args;
 		vector<string> normal_args;
+		FunctionInfo * callee = is_sysfunc ? nullptr : get_function(get_context().current_module, head_name);
+		bool is_subprogram = callee != nullptr;
+		// arguments of a `pure` function are `intent(in)`, so they are passed as they are, and array arguments of an `elemental` one select `FOR_ELEMENTAL`
+		bool is_pure_function = callee != nullptr && callee->pure && !callee->is_subroutine();
+		auto gen_actual_arg = [&](const ParseNode & arg) {
+			/**************
+			* an array section passed to a subprogram is a view of the array if it is contiguous, ref `forsection`
+			*	, so it is neither copied nor loses what the subprogram writes to it
+			* an `elemental` function takes the section as an `farray`, ref `FOR_ELEMENTAL`
+			***************/
+			const string & arg_str = arg.get_what();
+			const string slice_call = "forslice(";
+			if (is_subprogram && !callee->elemental && arg.token_equals(TokenMeta::NT_FUCNTIONARRAY) && arg.length() > 1 && arg.get(1).token_equals(TokenMeta::NT_DIMENSLICE)
+				&& arg_str.compare(0, slice_call.size(), slice_call) == 0)
+			{
+				return "forsection(" + arg_str.substr(slice_call.size());
+			}
+			return arg_str;
+		};
 		for (int i = 0; i < argtable.length(); i++)
 		{
 			ParseNode & elem = argtable.get(i);
@@ -131,7 +229,7 @@ void regen_function_array(FunctionInfo * finfo, ParseNode & callable) {
 				{
 					// normal argument
 					regen_exp(finfo, elem.get(0));
-					normal_args.push_back(elem.get(0).get_what());
+					normal_args.push_back(gen_actual_arg(elem.get(0)));
 					normal_count++;
 				}
 				else {
@@ -151,7 +249,7 @@ void regen_function_array(FunctionInfo * finfo, ParseNode & callable) {
 			else {
 				// normal argument
 				regen_exp(finfo, elem);
-				normal_args.push_back(elem.get_what());
+				normal_args.push_back(gen_actual_arg(elem));
 
 				// generated code from normal_args
 				if (valid_kwargs_test) {
@@ -163,14 +261,22 @@ void regen_function_array(FunctionInfo * finfo, ParseNode & callable) {
 			}
 		}
 
+		if (is_sysfunc && regen_inline_reduction(finfo, callable, head_name))
+		{
+			return;
+		}
 		argtable_str += make_str_list(normal_args.begin(), normal_args.end(), [&](string p) {
 			// origin: a, b, 1
 			// TODO: this is a temporary solution
 			// fortran: INOUT(a), INOUT(b), INOUT(1)
-			if (is_sysfunc)
+			if (is_sysfunc || p.compare(0, 11, "forsection(") == 0)
 			{
 				return p;
 			}
+			else if (is_pure_function) {
+				sprintf(codegen_buf, "IN(%s)", p.c_str());
+				return string(codegen_buf);
+			}
 			else {
 				sprintf(codegen_buf, "INOUT(%s)", p.c_str());
 				return string(codegen_buf);
@@ -70,7 +70,10 @@ const std::map<std::string, std::string> funcname_map{
     {"maxloc", "formaxloc"},
     {"minloc", "forminloc"},
     {"maxval", "formaxval"},
-    {"minval", "forminval"}
+    {"minval", "forminval"},
+    {"count", "forcount"},
+    {"any", "forany"},
+    {"all", "forall"}
 
     // file
     ,
@@ -136,7 +139,10 @@ const std::map<std::string, std::vector<KeywordParamInfo>> sysfunc_args = {
     {"formaxval", {{"dim", "int", ""}, {"mask", "mask_wrapper_t", ""}}},
     {"forminval", {{"dim", "int", ""}, {"mask", "mask_wrapper_t", ""}}},
     {"formaxloc", {{"dim", "int", ""}, {"mask", "mask_wrapper_t", ""}}},
-    {"forminloc", {{"dim", "int", ""}, {"mask", "mask_wrapper_t", ""}}}
+    {"forminloc", {{"dim", "int", ""}, {"mask", "mask_wrapper_t", ""}}},
+    {"forcount", {{"dim", "int", ""}}},
+    {"forany", {{"dim", "int", ""}}},
+    {"forall", {{"dim", "int", ""}}}
 
     ,
     {"abs", {}},
@@ -163,7 +169,9 @@ const std::map<std::string, std::vector<KeywordParamInfo>> sysfunc_args = {
     {"to_int", {}},
     {"to_bool", {}},
     {"to_string", {}},
+    {"to_float", {}},
     {"to_double", {}},
+    {"to_longdouble", {}},
     {"malloc", {{"size", "int", ""}}},
     {"to_forcomplex", {}}
 
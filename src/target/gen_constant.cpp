@@ -0,0 +1,262 @@
+/*
+*   Calvin Neo
+*   Copyright (C) 2016  Calvin Neo <calvinneo@calvinneo.com>
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License along
+*   with this program; if not, write to the Free Software Foundation, Inc.,
+*   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "gen_common.h"
+#include <climits>
+#include <cmath>
+
+/**************************************
+* constant folding of integer and real expressions
+*	an expression of literals, named constants(`parameter`) and `+ - * / ( )` is evaluated
+*	when it is generated, so array bounds and loop limits become literals,
+*	and the translator can decide e.g. if an array is a `fstaticarray`
+* integers are evaluated as `int`, reals of kind 4 as `float` and the others as `double`,
+*	which is what C++ does for the generated code, so folding never changes a result.
+*	expressions which overflow `int`, divide by zero, raise a real to a power
+*	or are of `long double` are left to the C++ compiler
+***************************************/
+
+namespace {
+	const int max_fold_depth = 32; // named constants defined by named constants
+
+	bool parse_literal(const std::string & str, ConstValue & value) {
+		if (str.empty())
+		{
+			return false;
+		}
+		const char * b = str.c_str();
+		char * e;
+		long long i = std::strtoll(b, &e, 10);
+		if (*e == '\0')
+		{
+			value = ConstValue{ true, i, (double)i };
+			return i >= INT_MIN && i <= INT_MAX;
+		}
+		double d = std::strtod(b, &e);
+		if (*e == '\0' && std::isfinite(d))
+		{
+			value = ConstValue{ false, 0, d };
+			return true;
+		}
+		else if (*e == 'f' && *(e + 1) == '\0' && std::isfinite(d)) {
+			// `float` literal, ref `gen_real_literal_term`
+			value = ConstValue{ false, 0, (double)std::strtof(b, nullptr), 4 };
+			return true;
+		}
+		return false;
+	}
+
+	bool eval_const_exp(FunctionInfo * finfo, const ParseNode & exp, ConstValue & value, int depth);
+
+	bool eval_parameter(FunctionInfo * finfo, const ParseNode & name, ConstValue & value, int depth) {
+		// value of a named constant, converted to its type
+		VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, name.get_what());
+		if (vinfo == nullptr)
+		{
+			vinfo = get_variable(get_context().current_module, "", name.get_what());
+		}
+		if (vinfo == nullptr || vinfo->declared || vinfo->entity_variable.length() < 2 || is_function_array(vinfo->entity_variable)
+			|| vinfo->entity_variable.get(1).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY))
+		{
+			return false;
+		}
+		// `parameter` of `integer, parameter :: n = 1` is not merged into `vinfo->desc` until `regen_vardef`
+		VariableDesc desc = vinfo->desc;
+		VariableDescAttr * type_attr = dynamic_cast<VariableDescAttr *>(vinfo->type.attr);
+		if (type_attr != nullptr)
+		{
+			desc.merge(type_attr->desc);
+		}
+		if (!desc.constant.get() || desc.reference.get() || desc.slice.is_initialized() || desc.allocatable.get())
+		{
+			return false;
+		}
+		if (!eval_const_exp(finfo, vinfo->entity_variable.get(1), value, depth + 1))
+		{
+			return false;
+		}
+		if (vinfo->type.token_equals(TokenMeta::Int_Decl) || (is_int(vinfo->type) && !vinfo->type.token_equals(TokenMeta::Char)))
+		{
+			value = ConstValue{ true, value.is_int ? value.i : (long long)value.d, value.is_int ? (double)value.i : std::trunc(value.d) };
+			return value.i >= INT_MIN && value.i <= INT_MAX;
+		}
+		else if (int kind = get_real_kind(vinfo->type, desc)) {
+			if (kind > 8)
+			{
+				return false;
+			}
+			value = kind <= 4 ? ConstValue{ false, 0, (double)(float)value.d, 4 } : ConstValue{ false, 0, value.d, 8 };
+			return true;
+		}
+		return false;
+	}
+
+	bool eval_binary(TokenMeta_T op, const ConstValue & x, const ConstValue & y, ConstValue & value) {
+		if (x.is_int && y.is_int)
+		{
+			long long r;
+			switch (op)
+			{
+			case TokenMeta::Add: r = x.i + y.i; break;
+			case TokenMeta::Minus: r = x.i - y.i; break;
+			case TokenMeta::Multiply: r = x.i * y.i; break;
+			case TokenMeta::Divide:
+				if (y.i == 0)
+				{
+					return false;
+				}
+				r = x.i / y.i;
+				break;
+			case TokenMeta::Power:
+				if (y.i < 0 || y.i > 62)
+				{
+					return false;
+				}
+				r = 1;
+				for (long long k = 0; k < y.i; k++)
+				{
+					r *= x.i;
+					if (r < INT_MIN || r > INT_MAX)
+					{
+						return false;
+					}
+				}
+				break;
+			default:
+				return false;
+			}
+			value = ConstValue{ true, r, (double)r };
+			return r >= INT_MIN && r <= INT_MAX;
+		}
+		double r;
+		// as the usual arithmetic conversions, `float` op `float` is `float`
+		int kind = x.is_int ? y.kind : (y.is_int ? x.kind : std::max(x.kind, y.kind));
+		switch (op)
+		{
+		case TokenMeta::Add: r = x.d + y.d; break;
+		case TokenMeta::Minus: r = x.d - y.d; break;
+		case TokenMeta::Multiply: r = x.d * y.d; break;
+		case TokenMeta::Divide:
+			if (y.d == 0)
+			{
+				return false;
+			}
+			r = x.d / y.d;
+			break;
+		default:
+			// `power` is `powl`, which is not `double`
+			return false;
+		}
+		if (kind <= 4)
+		{
+			// a `double` result rounded to `float` is the `float` result of `+ - * /`
+			r = (double)(float)r;
+		}
+		value = ConstValue{ false, 0, r, kind };
+		return std::isfinite(r);
+	}
+
+	bool eval_const_exp(FunctionInfo * finfo, const ParseNode & exp, ConstValue & value, int depth) {
+		if (depth > max_fold_depth)
+		{
+			return false;
+		}
+		if (exp.token_equals(TokenMeta::NT_EXPRESSION))
+		{
+			if (exp.length() == 2)
+			{
+				TokenMeta_T op = exp.get(1).get_token();
+				if (!eval_const_exp(finfo, exp.get(0), value, depth))
+				{
+					return false;
+				}
+				if (op == TokenMeta::Neg)
+				{
+					value = ConstValue{ value.is_int, -value.i, -value.d, value.kind };
+					return true;
+				}
+				return op == TokenMeta::Pos || op == TokenMeta::LB;
+			}
+			else if (exp.length() == 3) {
+				ConstValue x, y;
+				return eval_const_exp(finfo, exp.get(0), x, depth) && eval_const_exp(finfo, exp.get(1), y, depth)
+					&& eval_binary(exp.get(2).get_token(), x, y, value);
+			}
+			return false;
+		}
+		else if (exp.length() > 0 || is_str(exp)) {
+			return false;
+		}
+		else if (is_int(exp) || is_floating(exp)) {
+			return parse_literal(exp.get_what(), value);
+		}
+		else if (exp.token_equals(TokenMeta::UnknownVariant)) {
+			return eval_parameter(finfo, exp, value, depth);
+		}
+		return false;
+	}
+}
+
+bool eval_const_exp(FunctionInfo * finfo, const ParseNode & exp, ConstValue & value) {
+	return eval_const_exp(finfo, exp, value, 0);
+}
+
+std::string gen_const_literal(const ConstValue & value) {
+	if (value.is_int)
+	{
+		return std::to_string(value.i);
+	}
+	// the shortest literal which reads back as the same `double`, or `float`
+	std::string str;
+	for (int precision = 1; precision <= 17; precision++)
+	{
+		sprintf(codegen_buf, "%.*g", precision, value.d);
+		str = string(codegen_buf);
+		if (value.kind <= 4 ? std::strtof(str.c_str(), nullptr) == (float)value.d : std::strtod(str.c_str(), nullptr) == value.d)
+		{
+			break;
+		}
+	}
+	if (str.find_first_of(".e") == string::npos)
+	{
+		str += ".0";
+	}
+	return gen_real_literal_term(str, value.kind).what;
+}
+
+bool regen_folded_exp(FunctionInfo * finfo, ParseNode & exp) {
+	/**************************************
+	* replace the generated code of `exp` by its value
+	*	a named constant becomes a literal, so it is not looked up again when regenerated
+	***************************************/
+	ConstValue value;
+	if (!eval_const_exp(finfo, exp, value))
+	{
+		return false;
+	}
+	string literal = gen_const_literal(value);
+	if (exp.token_equals(TokenMeta::UnknownVariant))
+	{
+		exp.fs.CurrentTerm = Term{ value.is_int ? TokenMeta::Int : gen_real_term(value.kind).token, literal };
+	}
+	else {
+		exp.get_what() = literal;
+	}
+	return true;
+}
@@ -69,6 +69,7 @@ void regen_slice(FunctionInfo * finfo, ParseNode & slice) {
 			*	c = forslice(a, { {i}, {1, j} });
 			*```
 			***********/
+			codegen_buf[0] = '\0';
 		}
 		else if (slice.length() == 0)
 		{
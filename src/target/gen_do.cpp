@@ -29,23 +29,375 @@ void regen_do(FunctionInfo * finfo, ParseNode & do_stmt) {
 	do_stmt.fs.CurrentTerm = Term{ TokenMeta::NT_DO, string(codegen_buf) };
 }
 
+static void regen_do_range_omp(ParseNode & do_stmt, string omp_pragma, string label_line) {
+	/**************************************
+	* OpenMP requires a canonical loop
+	*======================================
+	*	#pragma omp for
+	*	for(i = a; i <= b; i += c){
+	*		...
+	*	}
+	*======================================
+	* the runtime computes the iteration count once before the loop, as fortran does
+	*	, so `from`/`to`/`step` are not hoisted
+	* if the sign of `step` is unknown, the relation operator can't be decided
+	*	, so iterate on the trip count and make `i` private instead
+	***************************************/
+	const string & var = do_stmt.get(0).get_what();
+	const string & from_str = do_stmt.get(1).get_what();
+	const string & to_str = do_stmt.get(2).get_what();
+	const string & step_str = do_stmt.get(3).get_what();
+	ParseNode & suite = do_stmt.get(4);
+	string trimmed_step = step_str;
+	trimmed_step.erase(std::remove(trimmed_step.begin(), trimmed_step.end(), ' '), trimmed_step.end());
+	int step_sign = 0;
+	if (is_literal(do_stmt.get(3)))
+	{
+		step_sign = 1;
+	}
+	else if (trimmed_step.size() > 1 && trimmed_step[0] == '-' 
+		&& trimmed_step.find_first_not_of("0123456789.", 1) == string::npos) {
+		step_sign = -1;
+	}
+	if (!omp_pragma.empty())
+	{
+		if (step_sign == 0 && !omp_clauses_mention(omp_pragma, var))
+		{
+			omp_pragma += " private(" + var + ")";
+		}
+		omp_pragma += "\n";
+	}
+	if (step_sign != 0)
+	{
+		sprintf(codegen_buf, "%sfor(%s = %s; %s %s %s; %s += %s){\n%s}"
+			, omp_pragma.c_str(), var.c_str(), from_str.c_str()
+			, var.c_str(), step_sign > 0 ? "<=" : ">=", to_str.c_str()
+			, var.c_str(), step_str.c_str(), tabber(suite.get_what()).c_str());
+	}
+	else {
+		sprintf(codegen_buf, "%sfor(fsize_t %s_trip = 0; %s_trip < fordo_tripcount(%s, %s, %s); %s_trip++){\n\t%s = %s + %s_trip * (%s);\n%s}"
+			, omp_pragma.c_str(), var.c_str(), var.c_str(), from_str.c_str(), to_str.c_str(), step_str.c_str(), var.c_str()
+			, var.c_str(), from_str.c_str(), var.c_str(), step_str.c_str(), tabber(suite.get_what()).c_str());
+	}
+	string loop_str = string(codegen_buf);
+	if (do_stmt.get(5).get_what().empty())
+	{
+		// loops collapsed by `collapse(n)` must be perfectly nested, so no `nop();` after them
+		label_line = "";
+	}
+	sprintf(codegen_buf, "%s%s", loop_str.c_str(), label_line.c_str());
+	do_stmt.fs.CurrentTerm = Term{ TokenMeta::NT_DORANGE, string(codegen_buf) };
+}
+
+static void regen_do_range_autopar(ParseNode & do_stmt, const ParallelLoopInfo & info, string label_line) {
+	/**************************************
+	* a loop proven parallel by `analyze_do_range`
+	*	with `--openmp` it is a `#pragma omp parallel for` loop
+	*	, otherwise it runs on the thread pool of the runtime
+	*======================================
+	*	forconcurrent_reduce({a}, {b}, {c}, s, forreduce_add(), [&, t](auto & s, fsize_t i) mutable{
+	*		...
+	*	});
+	*	i = a + fordo_tripcount(a, b, c) * (c);
+	*======================================
+	* private scalars are captured by copy, `s` is the accumulator of each chunk
+	* the bounds are not written by the loop, so the final value of `i` is computed after it
+	***************************************/
+	const string & var = do_stmt.get(0).get_what();
+	const string & from_str = do_stmt.get(1).get_what();
+	const string & to_str = do_stmt.get(2).get_what();
+	const string & step_str = do_stmt.get(3).get_what();
+	ParseNode & suite = do_stmt.get(4);
+	auto join = [](const std::vector<std::string> & names) {
+		string s;
+		for (const string & name : names)
+		{
+			s += (s.empty() ? "" : ", ") + name;
+		}
+		return s;
+	};
+	sprintf(codegen_buf, "%s = %s + fordo_tripcount(%s, %s, %s) * (%s);"
+		, var.c_str(), from_str.c_str(), from_str.c_str(), to_str.c_str(), step_str.c_str(), step_str.c_str());
+	string final_str = string(codegen_buf);
+	if (get_context().parse_config.openmp)
+	{
+		string pragma = "#pragma omp parallel for";
+		if (!info.private_names.empty())
+		{
+			pragma += " private(" + join(info.private_names) + ")";
+		}
+		if (!info.lastprivate_names.empty())
+		{
+			pragma += " lastprivate(" + join(info.lastprivate_names) + ")";
+		}
+		for (const std::tuple<std::string, std::string> & r : info.reductions)
+		{
+			pragma += " reduction(" + std::get<0>(r) + ":" + std::get<1>(r) + ")";
+		}
+		regen_do_range_omp(do_stmt, pragma, label_line);
+		do_stmt.get_what() += "\n" + final_str;
+		return;
+	}
+	string capture = "&";
+	for (const string & name : info.private_names)
+	{
+		capture += ", " + name;
+	}
+	string mutable_str = info.private_names.empty() ? "" : " mutable";
+	if (info.reductions.empty())
+	{
+		sprintf(codegen_buf, "forconcurrent({%s}, {%s}, {%s}, [%s](fsize_t %s)%s{\n%s});\n%s%s"
+			, from_str.c_str(), to_str.c_str(), step_str.c_str(), capture.c_str(), var.c_str(), mutable_str.c_str()
+			, tabber(suite.get_what()).c_str(), final_str.c_str(), label_line.c_str());
+	}
+	else {
+		const string & op = std::get<0>(info.reductions[0]);
+		const string & name = std::get<1>(info.reductions[0]);
+		string op_str = op == "+" ? "forreduce_add()" : op == "*" ? "forreduce_mul()" : op == "max" ? "forreduce_max()" : "forreduce_min()";
+		sprintf(codegen_buf, "forconcurrent_reduce({%s}, {%s}, {%s}, %s, %s, [%s](auto & %s, fsize_t %s)%s{\n%s});\n%s%s"
+			, from_str.c_str(), to_str.c_str(), step_str.c_str(), name.c_str(), op_str.c_str(), capture.c_str(), name.c_str(), var.c_str(), mutable_str.c_str()
+			, tabber(suite.get_what()).c_str(), final_str.c_str(), label_line.c_str());
+	}
+	do_stmt.fs.CurrentTerm = Term{ TokenMeta::NT_DORANGE, string(codegen_buf) };
+}
+
+static ParseNode * get_declared_slice(VariableInfo * vinfo) {
+	if (vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable))
+	{
+		// `real a(10)` keeps its shape in the entity until it is generated, ref `regen_vardef`
+		return &vinfo->entity_variable.get(0).get(1);
+	}
+	else if (vinfo->desc.slice.is_initialized()) {
+		return &vinfo->desc.slice.get();
+	}
+	return nullptr;
+}
+
+static void get_subscript_counts(const ParseNode & node, std::map<std::string, int> & counts) {
+	// `counts[a]` is the number of scalar subscripts of every `a(i, j)` in `node`, -1 if `a` is used otherwise
+	if (node.token_equals(TokenMeta::NT_FUCNTIONARRAY) && node.length() == 2 && node.get(0).length() == 0)
+	{
+		const ParseNode & argtable = node.get(1);
+		int count = argtable.token_equals(TokenMeta::NT_ARGTABLE_PURE) ? argtable.length() : -1;
+		for (const ParseNode * arg : argtable)
+		{
+			if (arg->token_equals(TokenMeta::NT_SLICE) || (arg->token_equals(TokenMeta::NT_KEYVALUE) && !arg->get(1).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY)))
+			{
+				count = -1;
+			}
+		}
+		const std::string & name = node.get(0).get_what();
+		std::map<std::string, int>::iterator it = counts.find(name);
+		counts[name] = (it == counts.end() || it->second == count) ? count : -1;
+		get_subscript_counts(argtable, counts);
+		return;
+	}
+	if (node.length() == 0 && node.token_equals(TokenMeta::UnknownVariant))
+	{
+		counts[node.get_what()] = -1;
+	}
+	for (const ParseNode * child : node)
+	{
+		get_subscript_counts(*child, counts);
+	}
+}
+
+static std::vector<std::pair<std::string, int>> get_rank_accessors(FunctionInfo * finfo, const ParseNode & suite) {
+	/**************************************
+	* arrays whose elements are the only use of them in a loop body, like `a(i, j)`,
+	*	are accessed by `forrank<2>(a)`, which is declared before the loop,
+	*	so strides are loaded once instead of in every iteration
+	* an array must have the rank of its declaration and a shape that can't change in the loop,
+	*	so arrays which are allocatable, pointers, in common blocks or used as a whole are excluded.
+	*	`fstaticarray`s are excluded too, because their strides are constants
+	*	, and so are arrays stored as struct-of-arrays, which are not `farray`s
+	***************************************/
+	std::vector<std::pair<std::string, int>> accessors;
+	if (!get_context().parse_config.usefarray)
+	{
+		return accessors;
+	}
+	std::map<std::string, int> counts;
+	get_subscript_counts(suite, counts);
+	for (const std::pair<const std::string, int> & x : counts)
+	{
+		if (x.second <= 0 || get_context().array_accessors.count(x.first))
+		{
+			continue;
+		}
+		VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, x.first);
+		ParseNode * slice = vinfo == nullptr ? nullptr : get_declared_slice(vinfo);
+		if (slice == nullptr || vinfo->vardef_node == nullptr || vinfo->commonblock_name != "" || slice->length() != x.second)
+		{
+			continue;
+		}
+		VariableDesc & desc = vinfo->desc;
+		if (desc.allocatable.get() || desc.pointer.get() || desc.cray_pointer.get() || desc.target.get() || desc.optional.get())
+		{
+			continue;
+		}
+		if (gen_static_array_typestr(finfo, vinfo, *slice) != "" || is_soa_type(vinfo->type.get_what()))
+		{
+			continue;
+		}
+		accessors.push_back(x);
+	}
+	return accessors;
+}
+
+static bool is_dummy_argument(FunctionInfo * finfo, const std::string & name) {
+	const std::vector<std::string> & params = finfo->funcdesc.paramtable_info;
+	return std::find(params.begin(), params.end(), name) != params.end();
+}
+
+static bool can_wrap_in_lambda(const ParseNode & node) {
+	// `return` and `goto` can't leave a lambda, and labels in it can't be jumped to from outside
+	if (node.token_equals(TokenMeta::Label) || node.token_equals(TokenMeta::Return) || node.token_equals(TokenMeta::Goto))
+	{
+		return false;
+	}
+	for (const ParseNode * child : node)
+	{
+		if (!can_wrap_in_lambda(*child))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 void regen_do_range(FunctionInfo * finfo, ParseNode & do_stmt){
+	/**************************************
+	* Fortran evaluates `from`, `to` and `step` ONCE before the loop,
+	*	and iterates exactly `max((to - from + step) / step, 0)` times.
+	*	so instead of
+	*	`for(i = a; i <= b; i += c)`
+	*	which re-evaluates `b` and `c` every iteration and is wrong when `c` < 0,
+	*	generate a counted loop
+	*======================================
+	*	i = a;
+	*	for(fsize_t i_trip = fordo_tripcount(a, b, c); i_trip > 0; i_trip--, i += c){
+	*		...
+	*	}
+	*======================================
+	* `from`/`to`/`step` which may change during the loop(e.g. function calls, array elements)
+	*	are hoisted into locals of an enclosing block before `i` is assigned
+	* with `--restrict`, accessors of array dummy arguments are parameters of a lambda wrapping the loop
+	*	, ref `forrank_restrict`
+	***************************************/
 	ParseNode & loop_variable = do_stmt.get(0);
 	ParseNode & exp1 = do_stmt.get(1);
 	ParseNode & exp2 = do_stmt.get(2);
 	ParseNode & exp3 = do_stmt.get(3);
 	ParseNode & suite = do_stmt.get(4);
     ParseNode & label = do_stmt.get(5);
+	// a loop bound to `!$omp do`, or collapsed into one
+	string omp_pragma = get_context().omp_loop_pragma;
+	bool omp_loop = !omp_pragma.empty() || get_context().omp_collapse > 0;
+	get_context().omp_loop_pragma = "";
+	if (omp_loop)
+	{
+		get_context().omp_collapse--;
+	}
+	// loops inside a parallelized loop stay serial
+	ParallelLoopInfo autopar_info;
+	if (!omp_loop && get_context().parse_config.autopar && get_context().autopar_depth == 0)
+	{
+		autopar_info = analyze_do_range(finfo, do_stmt, get_context().parse_config.openmp);
+		report_autopar(do_stmt, autopar_info);
+	}
 	regen_exp(finfo, exp1);
 	regen_exp(finfo, exp2);
 	regen_exp(finfo, exp3);
+	if (autopar_info.parallel)
+	{
+		get_context().autopar_depth++;
+	}
+	// parallel loops are generated as lambdas, accessors are declared by their inner loops
+	std::vector<std::pair<std::string, int>> accessors;
+	if (!omp_loop && !autopar_info.parallel)
+	{
+		accessors = get_rank_accessors(finfo, suite);
+	}
+	for (const std::pair<std::string, int> & x : accessors)
+	{
+		get_context().array_accessors[x.first] = x.first + "_at";
+	}
 	regen_suite(finfo, suite, true);
+	for (const std::pair<std::string, int> & x : accessors)
+	{
+		get_context().array_accessors.erase(x.first);
+	}
+	if (autopar_info.parallel)
+	{
+		get_context().autopar_depth--;
+	}
     string label_line = "\n"+label.get_what()+(label.get_what().empty()?string(""):string(":"))+"nop();";
-	sprintf(codegen_buf, "for(%s = %s; %s <= %s; %s += %s){\n%s}"
-		, loop_variable.get_what().c_str(), exp1.get_what().c_str()
-		, loop_variable.get_what().c_str(), exp2.get_what().c_str()
-		, loop_variable.get_what().c_str(), exp3.get_what().c_str(), tabber(suite.get_what()).c_str());
-    sprintf(codegen_buf,"%s%s",codegen_buf,label_line.c_str());
+	const string & var = loop_variable.get_what();
+	if (omp_loop)
+	{
+		if (!omp_pragma.empty())
+		{
+			get_context().omp_collapse = 0;
+		}
+		regen_do_range_omp(do_stmt, omp_pragma, label_line);
+		return;
+	}
+	if (autopar_info.parallel)
+	{
+		regen_do_range_autopar(do_stmt, autopar_info, label_line);
+		return;
+	}
+	string hoisted;
+	auto hoist = [&](ParseNode & exp, const string & suffix, bool keep_variable) {
+		/**************************************
+		* literals and folded constants are kept as is,
+		*	`from` and `to` which is a variable different from the loop variable are kept too,
+		*	because assigning `i` can't change them.
+		*	`step` is used in each iteration so the body must not be able to change it
+		***************************************/
+		ConstValue value;
+		if (is_literal(exp) || eval_const_exp(finfo, exp, value) || (keep_variable && is_element(exp) && exp.get_what() != var))
+		{
+			return exp.get_what();
+		}
+		string local_name = var + "_" + suffix;
+		sprintf(codegen_buf, "const auto %s = %s;\n", local_name.c_str(), exp.get_what().c_str());
+		hoisted += string(codegen_buf);
+		return local_name;
+	};
+	string from_str = hoist(exp1, "from", true);
+	string to_str = hoist(exp2, "to", true);
+	string step_str = hoist(exp3, "step", false);
+	bool restrict_dummies = get_context().parse_config.restrict_dummies && can_wrap_in_lambda(suite);
+	string restrict_params, restrict_args;
+	for (const std::pair<std::string, int> & x : accessors)
+	{
+		if (restrict_dummies && is_dummy_argument(finfo, x.first))
+		{
+			string delim = restrict_params.empty() ? "" : ", ";
+			restrict_params += delim + "auto " + x.first + "_at";
+			sprintf(codegen_buf, "%sforrank_restrict<%d>(%s)", delim.c_str(), x.second, x.first.c_str());
+			restrict_args += string(codegen_buf);
+			continue;
+		}
+		sprintf(codegen_buf, "auto %s_at = forrank<%d>(%s);\n", x.first.c_str(), x.second, x.first.c_str());
+		hoisted += string(codegen_buf);
+	}
+	sprintf(codegen_buf, "%s = %s;\nfor(fsize_t %s_trip = fordo_tripcount(%s, %s, %s); %s_trip > 0; %s_trip--, %s += %s){\n%s}"
+		, var.c_str(), from_str.c_str()
+		, var.c_str(), from_str.c_str(), to_str.c_str(), step_str.c_str()
+		, var.c_str(), var.c_str(), var.c_str(), step_str.c_str(), tabber(suite.get_what()).c_str());
+	string loop_str = string(codegen_buf);
+	if (!restrict_params.empty())
+	{
+		loop_str = "[&](" + restrict_params + "){\n" + tabber(loop_str) + "}(" + restrict_args + ");";
+	}
+	if (!hoisted.empty())
+	{
+		loop_str = "{\n" + tabber(hoisted + loop_str) + "}";
+	}
+	sprintf(codegen_buf, "%s%s", loop_str.c_str(), label_line.c_str());
 	do_stmt.fs.CurrentTerm = Term{ TokenMeta::NT_DORANGE, string(codegen_buf) };
 }
 
@@ -61,6 +413,204 @@ void regen_do_while(FunctionInfo * finfo, ParseNode & do_stmt) {
 	do_stmt.fs.CurrentTerm = Term{ TokenMeta::NT_WHILE, string(codegen_buf) };
 }
 
+struct ConcurrentHeader {
+	std::string from, to, step; // brace lists
+	std::string params; // lambda parameters
+	std::vector<std::string> indexes;
+};
+
+static ConcurrentHeader regen_concurrent_header(FunctionInfo * finfo, ParseNode & header) {
+	// the last child of NT_CONCURRENT_HEADER is the mask
+	ConcurrentHeader h;
+	for (int i = 0; i < header.length() - 1; i++)
+	{
+		ParseNode & control = header.get(i);
+		for (int j = 1; j < 4; j++)
+		{
+			regen_exp(finfo, control.get(j));
+		}
+		string delim = i == 0 ? "" : ", ";
+		h.from += delim + control.get(1).get_what();
+		h.to += delim + control.get(2).get_what();
+		h.step += delim + control.get(3).get_what();
+		h.params += delim + "fsize_t " + control.get(0).get_what();
+		h.indexes.push_back(control.get(0).get_what());
+	}
+	return h;
+}
+
+static void retarget_concurrent_cycle(ParseNode & node) {
+	// `cycle` ends the current iteration, which is the body lambda. inner loops keep theirs
+	if (node.token_equals(TokenMeta::NT_DO, TokenMeta::NT_DORANGE, TokenMeta::NT_WHILE, TokenMeta::NT_CONCURRENT, TokenMeta::NT_FORALL))
+	{
+		return;
+	}
+	if (node.token_equals(TokenMeta::NT_CONTROL_STMT) && node.length() > 0 && node.get(0).token_equals(TokenMeta::Continue))
+	{
+		node.get_what() = "return;";
+		return;
+	}
+	for (ParseNode * child : node)
+	{
+		retarget_concurrent_cycle(*child);
+	}
+}
+
+static void get_concurrent_private(FunctionInfo * finfo, const ParseNode & node, const ConcurrentHeader & h, std::vector<std::string> & names) {
+	/**************************************
+	* scalars assigned in the body, and variables of inner DO loops
+	*	are captured by copy, so each thread has its own
+	***************************************/
+	const ParseNode * defined = nullptr;
+	if (node.token_equals(TokenMeta::NT_EXPRESSION) && node.length() == 3 && node.get(2).token_equals(TokenMeta::Let))
+	{
+		defined = &node.get(0);
+	}
+	else if (node.token_equals(TokenMeta::NT_DORANGE))
+	{
+		defined = &node.get(0);
+	}
+	if (defined != nullptr && defined->token_equals(TokenMeta::META_WORD, TokenMeta::UnknownVariant))
+	{
+		const string & name = defined->get_what();
+		VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, name);
+		if (vinfo != nullptr && !vinfo->is_array() && !(vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable))
+			&& std::find(h.indexes.begin(), h.indexes.end(), name) == h.indexes.end()
+			&& std::find(names.begin(), names.end(), name) == names.end())
+		{
+			names.push_back(name);
+		}
+	}
+	for (const ParseNode * child : node)
+	{
+		get_concurrent_private(finfo, *child, h, names);
+	}
+}
+
+void regen_do_concurrent(FunctionInfo * finfo, ParseNode & do_stmt) {
+	/**************************************
+	* iterations of `do concurrent` can run in any order, so they are shared among threads
+	*======================================
+	*	forconcurrent({a1, a2}, {b1, b2}, {c1, c2}, [&](fsize_t i, fsize_t j){
+	*		if (!(mask)) {
+	*			return;
+	*		}
+	*		...
+	*	});
+	*======================================
+	***************************************/
+	ParseNode & header = do_stmt.get(0);
+	ParseNode & suite = do_stmt.get(1);
+	ParseNode & label = do_stmt.get(2);
+	ParseNode & mask = header.get(header.length() - 1);
+	ConcurrentHeader h = regen_concurrent_header(finfo, header);
+	string mask_str;
+	if (!mask.token_equals(TokenMeta::NT_DUMMY))
+	{
+		regen_exp(finfo, mask);
+		sprintf(codegen_buf, "if (!(%s)) {\n\treturn;\n}\n", mask.get_what().c_str());
+		mask_str = string(codegen_buf);
+	}
+	retarget_concurrent_cycle(suite);
+	regen_suite(finfo, suite, true);
+	std::vector<std::string> private_names;
+	get_concurrent_private(finfo, suite, h, private_names);
+	string capture = "&";
+	for (const string & name : private_names)
+	{
+		capture += ", " + name;
+	}
+	string label_line = "\n" + label.get_what() + (label.get_what().empty() ? string("") : string(":")) + "nop();";
+	sprintf(codegen_buf, "forconcurrent({%s}, {%s}, {%s}, [%s](%s)%s{\n%s});%s"
+		, h.from.c_str(), h.to.c_str(), h.step.c_str(), capture.c_str(), h.params.c_str()
+		, private_names.empty() ? "" : " mutable", tabber(mask_str + suite.get_what()).c_str(), label_line.c_str());
+	do_stmt.fs.CurrentTerm = Term{ TokenMeta::NT_CONCURRENT, string(codegen_buf) };
+}
+
+static void get_leaf_words(const ParseNode & node, std::vector<std::string> & words) {
+	if (node.length() == 0)
+	{
+		words.push_back(node.get_what());
+	}
+	for (const ParseNode * child : node)
+	{
+		get_leaf_words(*child, words);
+	}
+}
+
+void regen_forall(FunctionInfo * finfo, ParseNode & forall_stmt) {
+	/**************************************
+	* forall evaluates the mask and right side of an assignment for all indexes
+	*	before assigning any of them(7.5.4.4)
+	*	so an assignment to array `a` which reads `a` goes through `forall_assign` which keeps the values
+	*	, other assignments store directly, as `do concurrent` does
+	*	a nested forall or where goes through `forall_nested`, which evaluates the mask first
+	***************************************/
+	ParseNode & header = forall_stmt.get(0);
+	ParseNode & suite = forall_stmt.get(1);
+	ParseNode & label = forall_stmt.get(2);
+	ParseNode & mask = header.get(header.length() - 1);
+	bool has_mask = !mask.token_equals(TokenMeta::NT_DUMMY);
+	std::vector<std::string> mask_words;
+	if (has_mask)
+	{
+		get_leaf_words(mask, mask_words);
+		regen_exp(finfo, mask);
+	}
+	ConcurrentHeader h = regen_concurrent_header(finfo, header);
+	string bounds = "{" + h.from + "}, {" + h.to + "}, {" + h.step + "}";
+	string code;
+	for (ParseNode * pstmt : suite)
+	{
+		ParseNode & stmt = *pstmt;
+		if (stmt.token_equals(TokenMeta::NT_STATEMENT) && stmt.length() > 0 && stmt.get(0).token_equals(TokenMeta::NT_EXPRESSION)
+			&& stmt.get(0).length() == 3 && stmt.get(0).get(2).token_equals(TokenMeta::Let))
+		{
+			ParseNode & exp = stmt.get(0);
+			std::vector<std::string> lhs_words, rhs_words;
+			get_leaf_words(exp.get(0), lhs_words);
+			get_leaf_words(exp.get(1), rhs_words);
+			string lhs_name = lhs_words.empty() ? "" : lhs_words[0];
+			bool dependent = std::find(rhs_words.begin(), rhs_words.end(), lhs_name) != rhs_words.end()
+				|| std::find(mask_words.begin(), mask_words.end(), lhs_name) != mask_words.end();
+			regen_exp(finfo, exp);
+			const string & lhs_str = exp.get(0).get_what();
+			const string & rhs_str = exp.get(1).get_what();
+			if (dependent)
+			{
+				sprintf(codegen_buf, "forall_assign(%s\n\t, [&](%s){ return %s; }\n\t, [&](%s){ return %s; }\n\t, [&](const auto & forall_value, %s){ %s = forall_value; });\n"
+					, bounds.c_str(), h.params.c_str(), has_mask ? mask.get_what().c_str() : "true"
+					, h.params.c_str(), rhs_str.c_str(), h.params.c_str(), lhs_str.c_str());
+			}
+			else if (has_mask) {
+				sprintf(codegen_buf, "forconcurrent(%s, [&](%s){\n\tif (%s) {\n\t\t%s = %s;\n\t}\n});\n"
+					, bounds.c_str(), h.params.c_str(), mask.get_what().c_str(), lhs_str.c_str(), rhs_str.c_str());
+			}
+			else {
+				sprintf(codegen_buf, "forconcurrent(%s, [&](%s){\n\t%s = %s;\n});\n"
+					, bounds.c_str(), h.params.c_str(), lhs_str.c_str(), rhs_str.c_str());
+			}
+			code += string(codegen_buf);
+		}
+		else {
+			// nested forall and where run for each index selected by the mask of this forall, one index after another
+			string stmt_str = regen_stmt(finfo, stmt);
+			if (stmt_str.find_first_not_of("\n") == string::npos)
+			{
+				code += stmt_str;
+			}
+			else {
+				sprintf(codegen_buf, "forall_nested(%s, [&](%s){ return %s; }, [&](%s){\n%s});\n"
+					, bounds.c_str(), h.params.c_str(), has_mask ? mask.get_what().c_str() : "true"
+					, h.params.c_str(), tabber(stmt_str).c_str());
+				code += string(codegen_buf);
+			}
+		}
+	}
+	string label_line = label.get_what().empty() ? string("") : "\n" + label.get_what() + ":nop();";
+	sprintf(codegen_buf, "{\n%s}%s", tabber(code).c_str(), label_line.c_str());
+	forall_stmt.fs.CurrentTerm = Term{ TokenMeta::NT_FORALL, string(codegen_buf) };
+}
 
 std::vector<ParseNode *> get_nested_hiddendo_layers(ParseNode & hiddendo) {
 	std::vector<ParseNode *> hiddendo_layer;
@@ -121,6 +671,12 @@ SliceBoundInfo get_lbound_ubound_from_hiddendo(FunctionInfo * finfo, ParseNode &
 	return lb_ub;
 }
 
+static std::string gen_hiddendo_indexer(FunctionInfo * finfo, const ParseNode & index) {
+	// the implied-do variable has its declared type, so `(/ (i, i = 1, 6) /)` is an array of `int` rather than `fsize_t`
+	VariableInfo * vinfo = check_implicit_variable(finfo, index.get_what());
+	return vinfo->type.get_what() + " " + index.get_what();
+}
+
 void regen_hiddendo_expr(FunctionInfo * finfo, ParseNode & hiddendo, std::function<void(ParseNode &)> regen_innermost_argtable) {
 	/**************************************
 	* this function flatten a n-layer nested hidden do into an lambda function,
@@ -152,10 +708,10 @@ void regen_hiddendo_expr(FunctionInfo * finfo, ParseNode & hiddendo, std::functi
 		*	((F(I,J),J=1,2),I=3,4)
 		*	```
 		*	the indexer is
-		*	`fsize_t i, fsize_t j`
+		*	`int i, int j`
 		***************************************/
-		string indexer_str = make_str_list(hiddendo_layers.begin(), hiddendo_layers.end(), [](auto x)->string {
-			return "fsize_t " + (x)->get(1).get_what();
+		string indexer_str = make_str_list(hiddendo_layers.begin(), hiddendo_layers.end(), [&](auto x)->string {
+			return gen_hiddendo_indexer(finfo, x->get(1));
 		});
 
 		/**************************************
@@ -212,7 +768,7 @@ void regen_hiddendo_expr(FunctionInfo * finfo, ParseNode & hiddendo, std::functi
 		const ParseNode & index = hiddendo.get(1);
 		const ParseNode & from = hiddendo.get(2);
 		const ParseNode & to = hiddendo.get(3);
-		sprintf(codegen_buf, "[&](int %s){return %s ;}", index.get_what().c_str(), exp.get_what().c_str());
+		sprintf(codegen_buf, "[&](%s){return %s ;}", gen_hiddendo_indexer(finfo, index).c_str(), exp.get_what().c_str());
 		string str_lambda_body = string(codegen_buf);
 		sprintf(codegen_buf, "f1a_init_hiddendo(%s, %s, %s)", from.get_what().c_str(), to.get_what().c_str(), str_lambda_body.c_str());
 	}
@@ -253,8 +809,8 @@ void regen_hiddendo_exprex(FunctionInfo * finfo, ParseNode & hiddendo, std::func
 
 
 	std::vector<ParseNode *> hiddendo_layers = get_parent_hiddendo_layers(hiddendo);
-	string indexer_str = make_str_list(hiddendo_layers.rbegin(), hiddendo_layers.rend(), [](auto x)->string {
-		return "fsize_t " + (x)->get(1).get_what();
+	string indexer_str = make_str_list(hiddendo_layers.rbegin(), hiddendo_layers.rend(), [&](auto x)->string {
+		return gen_hiddendo_indexer(finfo, x->get(1));
 	});
 
 	sprintf(codegen_buf, "[&](%s){\n%s}", indexer_str.c_str(), tabber(innermost_code).c_str());
@@ -290,7 +846,7 @@ ParseNode gen_hiddendo(const ParseNode & argtable, const ParseNode & index, cons
 	ParseNode newnode = gen_token(Term{ TokenMeta::NT_HIDDENDO, "" });
 	newnode.addlist(argtable, index, from, to);
 	std::string stuff = "HIDDENDO GENERATED IN REGEN_HIDDENDO_XXX";
-	sprintf(codegen_buf, "for(int %s = %s; %s <= %s; %s++){\n%s}", index.get_what().c_str(), from.get_what().c_str()
+	sprintf(codegen_buf, "for(fsize_t %s = %s; %s <= %s; %s++){\n%s}", index.get_what().c_str(), from.get_what().c_str()
 		, index.get_what().c_str(), to.get_what().c_str(), index.get_what().c_str(), tabber(stuff).c_str());
 	newnode.fs.CurrentTerm = Term{ TokenMeta::NT_HIDDENDO, string(codegen_buf) };
 	return newnode;
@@ -24,6 +24,37 @@ void parse_inner_variable(FunctionInfo *finfo, ParseNode &exp);
 
 void add_star(ParseNode &exp);
 
+void regen_real_literal_kind(FunctionInfo *finfo, ParseNode &exp) {
+    /* `1.0_dp`, `.93E7_QUAD` has its named kind-param as a child, ref `gen_real_literal`
+     * `1.0_singr` has a `literal_tail` child, which is also read by the assignment
+     **/
+    ParseNode &kind_param = exp.get(0);
+    int kind = 0;
+    if (kind_param.get_what() == "_singr") {
+        kind = 4;
+    } else if (kind_param.get_what() == "_fullr") {
+        kind = 8;
+    } else if (kind_param.token_equals(TokenMeta::UnknownVariant)) {
+        ConstValue value;
+        if (eval_const_exp(finfo, kind_param, value) && value.is_int) {
+            kind = (int)value.i;
+        } else {
+            print_error("kind-param must be a named integer constant: ", kind_param);
+        }
+    } else {
+        return;
+    }
+    std::string number = exp.get_what();
+    if (!number.empty() && (number.back() == 'f' || number.back() == 'L')) {
+        number.pop_back();
+    }
+    exp.fs.CurrentTerm = gen_real_literal_term(number, kind);
+    if (kind_param.token_equals(TokenMeta::UnknownVariant)) {
+        delete exp.child[0];
+        exp.child.clear();
+    }
+}
+
 void regen_exp(FunctionInfo *finfo, ParseNode &exp) {
     if (exp.token_equals(TokenMeta::NT_EXPRESSION)) {
         if (exp.length() == 2) {
@@ -32,6 +63,7 @@ void regen_exp(FunctionInfo *finfo, ParseNode &exp) {
             ParseNode &op = exp.get(1);
             sprintf(codegen_buf, op.get_what().c_str(), exp.get(0).get_what().c_str());
             exp.get_what() = string(codegen_buf);
+            regen_folded_exp(finfo, exp);
         } else if (exp.length() == 3) {
             // binary op
             regen_exp(finfo, exp.get(0));
@@ -39,6 +71,7 @@ void regen_exp(FunctionInfo *finfo, ParseNode &exp) {
             ParseNode &op = exp.get(2);
             sprintf(codegen_buf, op.get_what().c_str(), exp.get(0).get_what().c_str(), exp.get(1).get_what().c_str());
             exp.get_what() = string(codegen_buf);
+            regen_folded_exp(finfo, exp);
         } else if (exp.length() == 1) {
             // function_array, array_builder, hidden_do
             ParseNode &elem = exp.get(0);
@@ -48,6 +81,9 @@ void regen_exp(FunctionInfo *finfo, ParseNode &exp) {
             print_error("error expression: ", exp);
         }
     } else if (is_literal(exp)) {
+        if (is_floating(exp) && exp.length() == 1) {
+            regen_real_literal_kind(finfo, exp);
+        }
         if (exp.token_equals(TokenMeta::String)) {
             sprintf(codegen_buf, "SS(%s)", exp.get_what().c_str());
             exp.get_what() = string(codegen_buf);
@@ -66,14 +102,14 @@ void regen_exp(FunctionInfo *finfo, ParseNode &exp) {
             ParseNode & literal_tail = exp.father->get(1).get(0);
             if(literal_tail.get_what()=="_fullr")
             {
-                vinfo->type.fs.CurrentTerm = Term{ TokenMeta::LongDouble, "long double" };
+                vinfo->type.fs.CurrentTerm = gen_real_term(8);
                 vinfo->desc.kind = 8;
                 get_variabledesc_attr(*vinfo->vardef_node).kind = 8;
 
             }
             else if(literal_tail.get_what()=="_singr")
             {
-                vinfo->type.fs.CurrentTerm = Term{ TokenMeta::Double, "double" };
+                vinfo->type.fs.CurrentTerm = gen_real_term(4);
                 vinfo->desc.kind = 4;
                 get_variabledesc_attr(*vinfo->vardef_node).kind = 4;
             }
@@ -96,6 +132,10 @@ void regen_exp(FunctionInfo *finfo, ParseNode &exp) {
                 get_variabledesc_attr(*vinfo->vardef_node).kind = 4;
             }
         }
+        if (exp.father == nullptr || !exp.father->token_equals(TokenMeta::NT_DERIVED_TYPE)) {
+            // a named constant is replaced by its value
+            regen_folded_exp(finfo, exp);
+        }
     } else if (exp.token_equals(TokenMeta::NT_FUCNTIONARRAY)) {
         // derived type construction, NOTICE: such approach will be exclusive with the original usage, i.e., variable or function followed by `(argtable)`
         if (get_type(get_context().current_module, exp.get(0).get_what().c_str()) != nullptr) {
@@ -18,6 +18,7 @@
 */
 
 #include "gen_common.h"
+#include <boost/algorithm/string.hpp>
 
 std::string gen_paramtable_str(FunctionInfo * finfo, const vector<string> & paramtable_info, bool with_name) {
 	// generate C++ style parameter list for function def or decl
@@ -248,9 +249,11 @@ void regen_function_2(FunctionInfo * finfo) {
 
 
 	// generate function code 
-	sprintf(codegen_buf, "%s\n{\n%s\treturn %s;\n}\n"
+	std::string profile = gen_profile_stmt(finfo->local_name);
+	sprintf(codegen_buf, "%s%s\n{\n%s\treturn %s;\n}\n"
+		, gen_line_directive(decl_node).c_str()
 		, signature.c_str()
-		, tabber(oldsuite.to_string()).c_str() // code
+		, tabber(profile + oldsuite.to_string()).c_str() // code
 		, (finfo->is_subroutine() ? "" : finfo->result_name.c_str()) // add return stmt if not function
 	);
     for(std::string sig:signatures_for_alias)
@@ -258,7 +261,7 @@ void regen_function_2(FunctionInfo * finfo) {
         sprintf(codegen_buf, "%s\n%s\n{\n%s\treturn %s;\n}\n"
                 , codegen_buf
                 , sig.c_str()
-                , tabber(oldsuite.to_string()).c_str() // code
+                , tabber(profile + oldsuite.to_string()).c_str() // code
                 , (finfo->is_subroutine() ? "" : finfo->result_name.c_str()) // add return stmt if not function
         );
     }
@@ -274,6 +277,130 @@ void regen_function(FunctionInfo * finfo, ParseNode & functiondecl_node) {
 	return;
 }
 
+void set_function_prefix(FunctionInfo * finfo, const ParseNode & functiondecl_node) {
+	/****************
+	* called by `gen_program` when the function is added
+	*	, so calls to it know it is `pure` before it is generated
+	* `recursive` needs nothing in C++
+	*****************/
+	for (const ParseNode * prefix : functiondecl_node.get(0))
+	{
+		std::string name = boost::to_lower_copy(prefix->get_what());
+		if (name == "elemental")
+		{
+			finfo->elemental = true;
+			finfo->pure = true;
+		}
+		else if (name == "pure") {
+			finfo->pure = true;
+		}
+	}
+	finfo->result_name = functiondecl_node.get(3).get_what();
+}
+
+std::string gen_profile_stmt(const std::string & procedure_name) {
+	/****************
+	* with `--instrument`, every procedure counts its calls and time in the `forprofile_registry`
+	*	, which is printed when the program exits
+	*****************/
+	if (!get_context().parse_config.instrument)
+	{
+		return "";
+	}
+	std::string name = get_context().current_module == "" ? procedure_name : get_context().current_module + "::" + procedure_name;
+	return "FOR_PROFILE(\"" + name + "\");\n";
+}
+
+namespace {
+	bool returns_scalar(FunctionInfo * finfo) {
+		VariableInfo * result_vinfo = get_variable(get_context().current_module, finfo->local_name, finfo->result_name);
+		return !finfo->is_subroutine() && result_vinfo != nullptr && !result_vinfo->desc.slice.is_initialized() && is_arithmetic_type(result_vinfo->type);
+	}
+
+	bool is_const_function(FunctionInfo * finfo, std::vector<FunctionInfo *> & callers);
+
+	bool is_host_variable(FunctionInfo * finfo, const std::string & name, VariableInfo * vinfo) {
+		// a variable of the module of `finfo`, which is neither a dummy argument nor declared in `finfo`
+		const std::vector<std::string> & params = finfo->funcdesc.paramtable_info;
+		return !get_context().current_module.empty() && get_variable(get_context().current_module, "", name) != nullptr
+			&& std::find(params.begin(), params.end(), name) == params.end() && vinfo->implicit_defined;
+	}
+
+	bool has_const_body(FunctionInfo * finfo, const ParseNode & node, std::vector<FunctionInfo *> & callers) {
+		// `finfo` reads only its dummy arguments and locals, and every user procedure it calls is `FOR_CONST`, intrinsics are
+		if (node.length() == 0 && node.token_equals(TokenMeta::UnknownVariant))
+		{
+			const std::string & name = node.get_what();
+			VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, name);
+			if (vinfo != nullptr)
+			{
+				// the body of a dummy procedure or of an interface is not known
+				// , and a module variable may change between calls
+				return !vinfo->type.token_equals(TokenMeta::Function) && !is_host_variable(finfo, name, vinfo);
+			}
+			FunctionInfo * callee = get_function(get_context().current_module, name);
+			if (callee == nullptr || callee == finfo)
+			{
+				return true;
+			}
+			// mutually recursive functions are `FOR_CONST` if nothing else they call reads memory
+			return std::find(callers.begin(), callers.end(), callee) != callers.end() || is_const_function(callee, callers);
+		}
+		for (const ParseNode * child : node)
+		{
+			if (!has_const_body(finfo, *child, callers))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool is_const_function(FunctionInfo * finfo, std::vector<FunctionInfo *> & callers) {
+		if (!finfo->pure || !returns_scalar(finfo) || !finfo->use_stmts.empty() || !finfo->funcdesc.declared_commons.empty())
+		{
+			return false;
+		}
+		for (auto iter = finfo->funcdesc.paramtable_info.begin(); iter + 1 < finfo->funcdesc.paramtable_info.end(); iter++)
+		{
+			VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, *iter);
+			if (vinfo == nullptr || vinfo->desc.optional || !vinfo->desc.reference || !vinfo->desc.constant
+				|| vinfo->desc.slice.is_initialized() || !is_arithmetic_type(vinfo->type))
+			{
+				return false;
+			}
+		}
+		if (finfo->suite == nullptr)
+		{
+			return false;
+		}
+		callers.push_back(finfo);
+		bool const_body = has_const_body(finfo, *finfo->suite, callers);
+		callers.pop_back();
+		return const_body;
+	}
+}
+
+std::string gen_function_attributes(FunctionInfo * finfo) {
+	/****************
+	* a `pure` function has no side effects, so it is `inline` and the C++ compiler is told so
+	*	`FOR_CONST` if it reads nothing but its arguments, which are passed by value, and calls only `FOR_CONST` functions
+	*	, and `FOR_PURE` if it reads arrays passed by reference, or `common` and module variables, itself or through a callee
+	* subroutines and functions returning arrays or strings are only `inline`
+	* with `--instrument`, all are only `inline`, because counting calls is a side effect
+	*****************/
+	if (!finfo->pure)
+	{
+		return "";
+	}
+	if (get_context().parse_config.instrument || !returns_scalar(finfo))
+	{
+		return "inline ";
+	}
+	std::vector<FunctionInfo *> callers;
+	return is_const_function(finfo, callers) ? "inline FOR_CONST " : "inline FOR_PURE ";
+}
+
 std::vector<std::string> gen_func_alias_signature(FunctionInfo * finfo) {
     bool is_subroutine = finfo->result_name.empty();
     std::string result_type_str;
@@ -316,7 +443,8 @@ std::string gen_function_signature(FunctionInfo * finfo, int style) {
 	{
 		// forward declaration
 		std::string paramtblstr = gen_paramtable_str(finfo, finfo->funcdesc.paramtable_info, true);
-		sprintf(codegen_buf, "%s %s(%s)"
+		sprintf(codegen_buf, "%s%s %s(%s)"
+			, gen_function_attributes(finfo).c_str() // `inline` if `pure`
 			, result_type_str.c_str() // return value type, "void" if subroutine
 			, finfo->local_name.c_str() // function name
 			, paramtblstr.c_str() // parameter list
@@ -396,4 +524,61 @@ void regen_derived_type_2(TypeInfo* tinfo) {
 		, tabber(oldsuite.to_string()).c_str() // code
 	);
 	decl_node.get_what() = string(codegen_buf);
+	if (is_soa_type(tinfo->local_name))
+	{
+		decl_node.get_what() += gen_soa_definition(tinfo);
+	}
+	else if (get_context().soa_types.find(tinfo->local_name) != get_context().soa_types.end())
+	{
+		print_error("arrays of " + tinfo->local_name + " are stored as array of structs, because not all its components are scalars");
+	}
+}
+
+std::string gen_soa_definition(TypeInfo * tinfo) {
+	/*****************
+	* an array of derived type `point` is stored as struct-of-arrays `point_soa`
+	*	, which holds one `farray` of the same shape for every component, so a loop over `p(i)%x` is unit-stride
+	* `p(i)` is a `point_ref` which refers to the components of the element, so `p(i).x` is still valid
+	*	and it converts from and to `point`
+	* `p%x` is the `fcomponentarray` of the component, an assignment to it writes the elements and never rebinds it
+	*****************/
+	// names of parameters and locals begin with `_`, which is not a valid fortran name, so they never hide a component
+	std::vector<VariableInfo *> components;
+	forall_variable_in_function(get_context().current_module, tinfo->local_name, [&](const std::pair<std::string, VariableInfo *> & p) {
+		components.push_back(p.second);
+	});
+	const string & name = tinfo->local_name;
+	string ref_members, soa_members, to_value, from_value, lb_sz_init, reset, elements;
+	for (VariableInfo * vinfo : components)
+	{
+		const string & member = vinfo->local_name;
+		const string & type_str = vinfo->type.get_what();
+		ref_members += "\t" + type_str + " & " + member + ";\n";
+		soa_members += "\tfcomponentarray<" + type_str + "> " + member + ";\n";
+		to_value += " _r." + member + " = " + member + ";";
+		from_value += " " + member + " = _v." + member + ";";
+		lb_sz_init += string(lb_sz_init == "" ? " : " : ", ") + member + "(_lb, _sz)";
+		reset += " " + member + ".reset_array(_tp);";
+		elements += string(elements == "" ? " " : ", ") + member + ".begin()[_k]";
+	}
+	const string & first = components[0]->local_name;
+	string code = "struct " + name + "_ref\n{\n" + ref_members
+		+ "\toperator " + name + "() const { " + name + " _r;" + to_value + " return _r; }\n"
+		+ "\tconst " + name + "_ref & operator=(const " + name + " & _v) const {" + from_value + " return *this; }\n"
+		+ "\tconst " + name + "_ref & operator=(const " + name + "_ref & _v) const { return *this = " + name + "(_v); }\n"
+		+ "};\n";
+	code += "struct " + name + "_soa\n{\n" + soa_members
+		+ "\t" + name + "_soa() { }\n"
+		+ "\ttemplate <int D>\n"
+		+ "\t" + name + "_soa(const fsize_t(&_lb)[D], const fsize_t(&_sz)[D])" + lb_sz_init + " { }\n"
+		+ "\ttemplate <int X>\n"
+		+ "\tvoid reset_array(const slice_info<fsize_t>(&_tp)[X]) {" + reset + " }\n"
+		+ "\ttemplate <typename... Args>\n"
+		+ "\t" + name + "_ref operator()(Args &&... _args) {\n"
+		+ "\t\t// all components have the same shape, so the offset of the element is computed once\n"
+		+ "\t\tfsize_t _k = &" + first + "(_args...) - " + first + ".begin();\n"
+		+ "\t\treturn " + name + "_ref{" + elements + " };\n"
+		+ "\t}\n"
+		+ "};\n";
+	return code;
 }
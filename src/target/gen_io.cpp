@@ -141,30 +141,94 @@ std::string gen_io_argtable_strex(FunctionInfo * finfo, ParseNode & argtable, st
 	return res;
 }
 
+bool has_io_implieddo(const ParseNode & argtable) {
+	for (ParseNode * p : argtable)
+	{
+		if (p->token_equals(TokenMeta::NT_HIDDENDO))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+std::string gen_io_list_item(FunctionInfo * finfo, ParseNode & argtable_item, std::string iofunc) {
+	if (argtable_item.token_equals(TokenMeta::NT_HIDDENDO))
+	{
+		// implied-do item, nested implied-do are nested loops
+		ParseNode & argtable = argtable_item.get(0);
+		ParseNode & index = argtable_item.get(1);
+		ParseNode & from = argtable_item.get(2);
+		ParseNode & to = argtable_item.get(3);
+		regen_exp(finfo, from);
+		regen_exp(finfo, to);
+		std::string body = make_str_list(argtable.begin(), argtable.end(), [&](ParseNode * p) {
+			return gen_io_list_item(finfo, *p, iofunc);
+		}, "");
+		sprintf(codegen_buf, "for(fsize_t %s = %s; %s <= %s; %s++){\n%s}\n", index.get_what().c_str(), from.get_what().c_str()
+			, index.get_what().c_str(), to.get_what().c_str(), index.get_what().c_str(), tabber(body).c_str());
+	}
+	else {
+		// normal item
+		regen_exp(finfo, argtable_item);
+		// read stmt require pointer as input
+		sprintf(codegen_buf, "io_list.item(%s%s);\n", (iofunc == "read" ? "&" : ""), argtable_item.get_what().c_str());
+	}
+	return string(codegen_buf);
+}
+
+std::string gen_io_list_block(FunctionInfo * finfo, ParseNode & argtable, std::string iofunc, std::string list_type, std::string list_args) {
+	/**************************************
+	* an io-list with implied-do is generated as `for` loops, which pass the items one by one,
+	*	rather than `make_implieddo`, whose lambdas and `std::function` are called for every item
+	* e.g. `write(*, *) n, (a(i), i = 1, n)`
+	*	```
+	*	{
+	*		forwritefree_list io_list(stdout);
+	*		io_list.item(n);
+	*		for(fsize_t i = 1; i <= n; i++){
+	*			io_list.item(a(i));
+	*		}
+	*		io_list.end();
+	*	}
+	*	```
+	***************************************/
+	std::string body = list_type + " io_list(" + list_args + ");\n";
+	for (ParseNode * p : argtable)
+	{
+		body += gen_io_list_item(finfo, *p, iofunc);
+	}
+	body += "io_list.end();\n";
+	return "{\n" + tabber(body) + "}\n";
+}
+
 void regen_read(FunctionInfo * finfo, ParseNode & stmt) {
 	const ParseNode & io_info = stmt.get(0);
 	ParseNode & argtable = stmt.get(1);
 	string device = io_info.get(0).to_string();
     bool is_2_string = io_info.get(0).token_equals(TokenMeta::META_STRING);
 	bool is_stdio = (!is_2_string)&&(device == "-1" || device == "" || device == "0");
-	std::string argtable_str = gen_io_argtable_strex(finfo, argtable, "read", io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER));
+	// an internal file is read through a `const char *`, so its implied-do still use `make_implieddo`
+	bool io_loops = has_io_implieddo(argtable) && !is_2_string;
+	std::string argtable_str = io_loops ? "" : gen_io_argtable_strex(finfo, argtable, "read", io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER));
+	// device = "5"; // stdin
+	string file = is_stdio ? "stdin" : (is_2_string ? device : "get_file(" + device + ")");
+	string code;
 
 	if (argtable.length() == 0)
 	{
 		// a read-stmt without args is equal to pause
 		// e.g. `read(*,*)`
-		sprintf(codegen_buf, "stop();\n");
+		code = "stop();\n";
 	}
 	else if (io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER)) {
-		if (is_stdio) {
-			// device = "5"; // stdin
-			sprintf(codegen_buf, "forreadfree(stdin%s %s);\n", (argtable_str==""?"":","), argtable_str.c_str());
+		if (io_loops)
+		{
+			code = gen_io_list_block(finfo, argtable, "read", "forreadfree_list", file);
 		}
-        else if(is_2_string){
-            sprintf(codegen_buf, "forreadfree(%s%s %s);\n", device.c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
-        }
 		else {
-			sprintf(codegen_buf, "forreadfree(get_file(%s)%s %s);\n", device.c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			sprintf(codegen_buf, "forreadfree(%s%s %s);\n", file.c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			code = string(codegen_buf);
 		}
 	}
 	else {
@@ -180,20 +244,22 @@ void regen_read(FunctionInfo * finfo, ParseNode & stmt) {
 		fmt = fmt.substr(1, (int)fmt.size() - 1); // strip " 
 		for90std::IOFormat ioformat = parse_ioformatter(fmt);
 		if (is_stdio) {
-			// device = "5"; // stdin
-			sprintf(codegen_buf, "forread(stdin, IOFormat{\"%s\", %d}%s %s);\n", ioformat.fmt.c_str()
-				, ioformat.reversion_start, (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			sprintf(codegen_buf, "IOFormat{\"%s\", %d}", ioformat.fmt.c_str(), ioformat.reversion_start);
 		}
-        else if(is_2_string){
-            sprintf(codegen_buf, "forread(%s, IOFormat{\"%s\", %d, %d}%s %s);\n", device.c_str()
-                    , ioformat.fmt.c_str(), ioformat.reversion_start, ioformat.reversion_end, (argtable_str == "" ? "" : ","), argtable_str.c_str());
-        }
 		else {
-			sprintf(codegen_buf, "forread(get_file(%s), IOFormat{\"%s\", %d, %d}%s %s);\n", device.c_str()
-				, ioformat.fmt.c_str(), ioformat.reversion_start, ioformat.reversion_end, (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			sprintf(codegen_buf, "IOFormat{\"%s\", %d, %d}", ioformat.fmt.c_str(), ioformat.reversion_start, ioformat.reversion_end);
+		}
+		string format = string(codegen_buf);
+		if (io_loops)
+		{
+			code = gen_io_list_block(finfo, argtable, "read", "forread_list", file + ", " + format);
+		}
+		else {
+			sprintf(codegen_buf, "forread(%s, %s%s %s);\n", file.c_str(), format.c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			code = string(codegen_buf);
 		}
 	}
-	stmt.fs.CurrentTerm = Term{ TokenMeta::NT_READ_STMT, string(codegen_buf) };
+	stmt.fs.CurrentTerm = Term{ TokenMeta::NT_READ_STMT, code };
 	return;
 }
 
@@ -204,14 +270,19 @@ void regen_write(FunctionInfo * finfo, ParseNode & stmt) {
 	ParseNode & argtable = stmt.get(1);
 	string device = io_info.get(0).to_string();
 	bool is_stdio = (device == "-1" || device == "" || device == "0");
-	std::string argtable_str = gen_io_argtable_strex(finfo, argtable, "write", io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER));
+	bool io_loops = has_io_implieddo(argtable);
+	std::string argtable_str = io_loops ? "" : gen_io_argtable_strex(finfo, argtable, "write", io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER));
+	// device = "6"; // stdout
+	string file = is_stdio ? "stdout" : "get_file(" + device + ")";
+	string code;
 	if (io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER)) {
-		if (is_stdio) {
-			// device = "6"; // stdout
-			sprintf(codegen_buf, "forwritefree(stdout%s %s);\n", (argtable_str == "" ? "" : ","), argtable_str.c_str());
+		if (io_loops)
+		{
+			code = gen_io_list_block(finfo, argtable, "write", "forwritefree_list", file);
 		}
 		else {
-			sprintf(codegen_buf, "forwritefree(get_file(%s)%s %s);\n", device.c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			sprintf(codegen_buf, "forwritefree(%s%s %s);\n", file.c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			code = string(codegen_buf);
 		}
 	}
 	else {
@@ -225,25 +296,40 @@ void regen_write(FunctionInfo * finfo, ParseNode & stmt) {
 		fmt = fmt.substr(1, (int)fmt.size() - 1); // strip " 
 		for90std::IOFormat ioformat = parse_ioformatter(fmt);
 		if (is_stdio) {
-			// device = "6"; // stdout
-			sprintf(codegen_buf, "forwrite(stdout, IOFormat{\"%s\", %d}%s %s);\n", ioformat.fmt.c_str()
-				, ioformat.reversion_start, (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			sprintf(codegen_buf, "IOFormat{\"%s\", %d}", ioformat.fmt.c_str(), ioformat.reversion_start);
+		}
+		else {
+			sprintf(codegen_buf, "IOFormat{\"%s\", %d, %d}", ioformat.fmt.c_str(), ioformat.reversion_start, ioformat.reversion_end);
+		}
+		string format = string(codegen_buf);
+		if (io_loops)
+		{
+			code = gen_io_list_block(finfo, argtable, "write", "forwrite_list", file + ", " + format);
 		}
 		else {
-			sprintf(codegen_buf, "forwrite(get_file(%s), IOFormat{\"%s\", %d, %d}%s %s);\n", device.c_str()
-				, ioformat.fmt.c_str(), ioformat.reversion_start, ioformat.reversion_end, (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			sprintf(codegen_buf, "forwrite(%s, %s%s %s);\n", file.c_str(), format.c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			code = string(codegen_buf);
 		}
 	}
-	stmt.fs.CurrentTerm = Term{ TokenMeta::NT_WRITE_STMT, string(codegen_buf) };
+	stmt.fs.CurrentTerm = Term{ TokenMeta::NT_WRITE_STMT, code };
 	return;
 }
 
 void regen_print(FunctionInfo * finfo, ParseNode & stmt) {
 	const ParseNode & io_info = stmt.get(0);
 	ParseNode & argtable = stmt.get(1);
-	std::string argtable_str = gen_io_argtable_strex(finfo, argtable, "print", io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER));
+	bool io_loops = has_io_implieddo(argtable);
+	std::string argtable_str = io_loops ? "" : gen_io_argtable_strex(finfo, argtable, "print", io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER));
+	string code;
 	if (io_info.get(1).token_equals(TokenMeta::NT_AUTOFORMATTER)) {
-		sprintf(codegen_buf, "forprintfree(%s);\n", argtable_str.c_str());
+		if (io_loops)
+		{
+			code = gen_io_list_block(finfo, argtable, "print", "forwritefree_list", "stdout");
+		}
+		else {
+			sprintf(codegen_buf, "forprintfree(%s);\n", argtable_str.c_str());
+			code = string(codegen_buf);
+		}
 	}
 	else {
 		string fmt;
@@ -256,12 +342,18 @@ void regen_print(FunctionInfo * finfo, ParseNode & stmt) {
 		}
 		fmt = fmt.substr(1, (int)fmt.size() - 1); // strip " 
 		for90std::IOFormat ioformat = parse_ioformatter(fmt);
-		sprintf(codegen_buf, "forprint(\"%s\"%s %s);\n", parse_ioformatter(fmt).c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
-
-		sprintf(codegen_buf, "forprint(IOFormat{\"%s\", %d, %d}%s %s);\n", ioformat.fmt.c_str()
-			, ioformat.reversion_start, ioformat.reversion_end, (argtable_str == "" ? "" : ","), argtable_str.c_str());
+		sprintf(codegen_buf, "IOFormat{\"%s\", %d, %d}", ioformat.fmt.c_str(), ioformat.reversion_start, ioformat.reversion_end);
+		string format = string(codegen_buf);
+		if (io_loops)
+		{
+			code = gen_io_list_block(finfo, argtable, "print", "forwrite_list", "stdout, " + format);
+		}
+		else {
+			sprintf(codegen_buf, "forprint(%s%s %s);\n", format.c_str(), (argtable_str == "" ? "" : ","), argtable_str.c_str());
+			code = string(codegen_buf);
+		}
 	}
-	stmt.fs.CurrentTerm = Term{ TokenMeta::NT_PRINT_STMT, string(codegen_buf) };
+	stmt.fs.CurrentTerm = Term{ TokenMeta::NT_PRINT_STMT, code };
 	return;
 }
 
@@ -19,6 +19,7 @@
 
 #include "gen_common.h"
 #include <map>
+#include <functional>
 
 //3.2.5 Statement labels
 //A statement label provides a means of referring to an individual statement.
@@ -40,4 +41,269 @@ ParseNode require_format_index(FunctionInfo * finfo, std::string format_index) {
 	// read/write ֱʹformatкΪ
 	sprintf(codegen_buf, "LABEL_%s_%s", finfo->local_name.c_str(), format_index.c_str());
 	return get_context().labels[string(codegen_buf)];
-}
\ No newline at end of file
+}
+
+/**************************************
+* restructuring of `goto`
+*	loops and conditionals of F77 made of labels and `goto`s are recovered when `regen_suite` generates a suite
+*	, if the label and the `goto`s are stmts of this suite
+*	1. `L stmt ... if (c) goto L` is `do { stmt ... } while (c);`, and `L stmt ... goto L` is `for (;;) { ... }`
+*	2. `L if (c) goto M ... goto L` followed by `M` is `while (!(c)) { ... }`
+*	3. `if (c) goto M ... goto N` followed by `M ...` and `N` is `if (!(c)) { ... } else { M ... }`
+*	4. `if (c) goto M ...` followed by `M` is `if (!(c)) { ... }`
+*	in 1 and 2, L must not be referenced by other `goto`s, and `exit`/`cycle` of an enclosing loop must not be in the loop
+*	a label is not generated if all `goto`s to it are restructured
+*	computed `goto` and arithmetic `if` are `switch`, ref `regen_computed_goto`
+***************************************/
+
+namespace {
+	std::string gen_label_name(FunctionInfo * finfo, const std::string & label) {
+		sprintf(codegen_buf, "LABEL_%s_%s", finfo->local_name.c_str(), label.c_str());
+		return string(codegen_buf);
+	}
+
+	bool is_goto(const ParseNode & stmt, std::string & label) {
+		// `goto L`
+		if (stmt.token_equals(TokenMeta::NT_CONTROL_STMT) && stmt.length() > 0 && stmt.get(0).token_equals(TokenMeta::Goto) && stmt.get(0).length() == 0)
+		{
+			label = stmt.get(0).get_what();
+			return true;
+		}
+		return false;
+	}
+
+	bool is_if_goto(const ParseNode & stmt, std::string & label) {
+		// `if (c) goto L`
+		return stmt.token_equals(TokenMeta::NT_IF) && stmt.get(2).token_equals(TokenMeta::NT_DUMMY) && stmt.get(3).token_equals(TokenMeta::NT_DUMMY)
+			&& is_goto(stmt.get(1), label);
+	}
+
+	bool is_label(const ParseNode & stmt, const std::string & label) {
+		return stmt.token_equals(TokenMeta::Label) && stmt.get_what() == label;
+	}
+
+	int find_label(const ParseNode & suite, int begin, int end, const std::string & label) {
+		for (int i = begin; i < end; i++)
+		{
+			if (is_label(suite.get(i), label))
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	bool has_loop_jump(const ParseNode & stmt) {
+		// `exit` or `cycle` of an enclosing loop
+		if (stmt.token_equals(TokenMeta::Break))
+		{
+			return stmt.length() == 0 || !stmt.get(0).token_equals(TokenMeta::META_WORD);
+		}
+		else if (stmt.token_equals(TokenMeta::Continue)) {
+			return true;
+		}
+		else if (stmt.token_equals(TokenMeta::NT_DO, TokenMeta::NT_DORANGE, TokenMeta::NT_WHILE, TokenMeta::NT_CONCURRENT, TokenMeta::NT_FORALL)) {
+			return false;
+		}
+		for (const ParseNode * px : stmt)
+		{
+			if (has_loop_jump(*px))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool can_be_loop(const ParseNode & suite, int begin, int end) {
+		for (int i = begin; i < end; i++)
+		{
+			if (has_loop_jump(suite.get(i)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool has_omp_directive(const ParseNode & suite, int begin, int end) {
+		if (get_context().omp_directives.empty())
+		{
+			return false;
+		}
+		for (int i = begin; i < end; i++)
+		{
+			int pos = get_source_pos(suite.get(i));
+			if (pos != -1 && get_context().omp_directives.find(pos) != get_context().omp_directives.end())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	int get_goto_refs(FunctionInfo * finfo, const std::string & label) {
+		auto iter = get_context().goto_refs.find(gen_label_name(finfo, label));
+		return iter == get_context().goto_refs.end() ? 0 : iter->second;
+	}
+
+	void restructure_goto(FunctionInfo * finfo, const std::string & label) {
+		get_context().goto_refs[gen_label_name(finfo, label)]--;
+		get_context().goto_restructured++;
+	}
+
+	std::string regen_goto_condition(FunctionInfo * finfo, ParseNode & if_stmt) {
+		ParseNode & exp = if_stmt.get(0);
+		regen_exp(finfo, exp);
+		return exp.get_what();
+	}
+}
+
+int log_goto_refs(FunctionInfo * finfo, const ParseNode & suite) {
+	/**************************************
+	* count `goto`s to each label of the function
+	*	, and returns the count of `goto` stmts
+	***************************************/
+	int gotos = 0;
+	std::function<void(const ParseNode &)> log_refs = [&](const ParseNode & stmt) {
+		if (stmt.token_equals(TokenMeta::Goto))
+		{
+			gotos++;
+			if (stmt.length() == 0)
+			{
+				get_context().goto_refs[gen_label_name(finfo, stmt.get_what())]++;
+			}
+			else {
+				// computed `goto` or arithmetic `if`, whose labels are restructured into a `switch` rather than removed
+				for (const ParseNode * label : stmt.get(0))
+				{
+					get_context().goto_refs[gen_label_name(finfo, label->get_what())]++;
+				}
+			}
+			return;
+		}
+		for (const ParseNode * px : stmt)
+		{
+			log_refs(*px);
+		}
+	};
+	log_refs(suite);
+	return gotos;
+}
+
+bool is_label_restructured(FunctionInfo * finfo, const std::string & label) {
+	auto iter = get_context().goto_refs.find(gen_label_name(finfo, label));
+	return iter != get_context().goto_refs.end() && iter->second == 0;
+}
+
+bool get_goto_region(FunctionInfo * finfo, ParseNode & suite, int begin, int end, GotoRegion & region) {
+	/**************************************
+	* find the region of stmts beginning at `begin` which can be restructured, ref "restructuring of `goto`"
+	*	stmts after `end` are not in the region
+	***************************************/
+	ParseNode & stmt = suite.get(begin);
+	std::string label, label_else, label_end;
+	if (stmt.token_equals(TokenMeta::Label) && begin + 1 < end && get_goto_refs(finfo, stmt.get_what()) == 1)
+	{
+		label = stmt.get_what();
+		// 2. `while`
+		int i = begin + 1;
+		int j = i + 1;
+		while (j < end && !(is_goto(suite.get(j), label_else) && label_else == label))
+		{
+			j++;
+		}
+		if (j + 1 < end && is_if_goto(suite.get(i), label_end) && is_label(suite.get(j + 1), label_end)
+			&& can_be_loop(suite, i + 1, j) && !has_omp_directive(suite, begin, j + 1))
+		{
+			sprintf(codegen_buf, "while (!(%s)) {", regen_goto_condition(finfo, suite.get(i)).c_str());
+			region = GotoRegion{ j + 1, string(codegen_buf), i + 1, j };
+			region.tail = "}";
+			restructure_goto(finfo, label);
+			restructure_goto(finfo, label_end);
+			return true;
+		}
+		// 1. `do while` or `for (;;)`
+		for (j = begin + 1; j < end; j++)
+		{
+			if ((is_if_goto(suite.get(j), label_end) || is_goto(suite.get(j), label_end)) && label_end == label)
+			{
+				break;
+			}
+		}
+		if (j < end && can_be_loop(suite, begin + 1, j) && !has_omp_directive(suite, begin, j + 1))
+		{
+			if (suite.get(j).token_equals(TokenMeta::NT_IF))
+			{
+				sprintf(codegen_buf, "} while (%s);", regen_goto_condition(finfo, suite.get(j)).c_str());
+				region = GotoRegion{ j + 1, "do {", begin + 1, j };
+				region.tail = string(codegen_buf);
+			}
+			else {
+				region = GotoRegion{ j + 1, "for (;;) {", begin + 1, j };
+				region.tail = "}";
+			}
+			restructure_goto(finfo, label);
+			return true;
+		}
+	}
+	else if (is_if_goto(stmt, label)) {
+		int j = find_label(suite, begin + 1, end, label);
+		if (j == -1 || has_omp_directive(suite, begin, j))
+		{
+			return false;
+		}
+		sprintf(codegen_buf, "if (!(%s)) {", regen_goto_condition(finfo, stmt).c_str());
+		// 3. `if else`
+		int k = j - 1 > begin && is_goto(suite.get(j - 1), label_else) ? find_label(suite, j + 1, end, label_else) : -1;
+		if (k != -1 && !has_omp_directive(suite, j, k))
+		{
+			region = GotoRegion{ k, string(codegen_buf), begin + 1, j - 1, j, k };
+			region.tail = "}";
+			restructure_goto(finfo, label);
+			restructure_goto(finfo, label_else);
+			return true;
+		}
+		// 4. `if`
+		region = GotoRegion{ j, string(codegen_buf), begin + 1, j };
+		region.tail = "}";
+		restructure_goto(finfo, label);
+		return true;
+	}
+	return false;
+}
+
+std::string regen_computed_goto(FunctionInfo * finfo, ParseNode & goto_stmt) {
+	/**************************************
+	* computed `goto (L1, L2, ...), i` jumps to the i-th label, or to the next stmt if there's no i-th label
+	* arithmetic `if (e) L1, L2, L3` jumps to L1, L2, L3 if `e` is negative, zero, positive
+	***************************************/
+	ParseNode & labels = goto_stmt.get(0);
+	ParseNode & exp = goto_stmt.get(1);
+	regen_exp(finfo, exp);
+	string cases;
+	for (int i = 0; i < labels.length(); i++)
+	{
+		if (goto_stmt.get_what() == "arithmetic")
+		{
+			sprintf(codegen_buf, "%s:\n\tgoto %s;\n", i == 0 ? "case -1" : (i == 1 ? "case 0" : "default"), gen_label_name(finfo, labels.get(i).get_what()).c_str());
+		}
+		else {
+			sprintf(codegen_buf, "case %d:\n\tgoto %s;\n", i + 1, gen_label_name(finfo, labels.get(i).get_what()).c_str());
+		}
+		cases += string(codegen_buf);
+	}
+	if (goto_stmt.get_what() == "arithmetic")
+	{
+		sprintf(codegen_buf, "{\n\tconst auto if_value = %s;\n\tswitch ((if_value > 0) - (if_value < 0)) {\n%s\t}\n}", exp.get_what().c_str(), tabber(cases).c_str());
+	}
+	else {
+		sprintf(codegen_buf, "switch ((int)(%s)) {\n%s}", exp.get_what().c_str(), cases.c_str());
+	}
+	return string(codegen_buf);
+}
+
+void report_goto(FunctionInfo * finfo, int gotos) {
+	fprintf(stderr, "Goto : %s, %d of %d gotos restructured, %d remain\n", finfo->local_name.c_str()
+		, get_context().goto_restructured, gotos, gotos - get_context().goto_restructured);
+}
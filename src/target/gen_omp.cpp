@@ -0,0 +1,430 @@
+/*
+*   Calvin Neo
+*   Copyright (C) 2016  Calvin Neo <calvinneo@calvinneo.com>
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License along
+*   with this program; if not, write to the Free Software Foundation, Inc.,
+*   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "gen_common.h"
+#include <boost/algorithm/string.hpp>
+
+/**************************************
+* OpenMP directives, enabled by `--openmp`
+* 1. the tokenizer logs `!$omp`/`c$omp` lines to `get_tokenizer_context().directives`
+* 2. `bind_omp_directives` parses them and binds each of them to the first stmt after it
+* 3. `regen_suite` calls `regen_omp_directives` before each stmt
+*	1) OMP_STANDALONE, e.g. `barrier`, is generated before the stmt
+*	2) OMP_BLOCK, e.g. `parallel`, encloses all stmts until its `end` directive in `{}`
+*	3) OMP_LOOP, e.g. `parallel do`, is handed to `regen_do_range` by `omp_loop_pragma`
+*		, because `#pragma omp for` must be followed by a canonical `for` stmt
+***************************************/
+
+struct OmpConstruct {
+	std::string construct;
+	std::string pragma;
+	OmpKind kind;
+};
+
+// longer constructs must be ahead of their prefixes
+static const std::vector<OmpConstruct> omp_constructs = {
+	{ "parallel do simd", "parallel for simd", OMP_LOOP },
+	{ "parallel do", "parallel for", OMP_LOOP },
+	{ "parallel sections", "parallel sections", OMP_BLOCK },
+	// c++ has no workshare, `parallel workshare` is executed serially
+	{ "parallel workshare", "", OMP_BLOCK },
+	{ "parallel", "parallel", OMP_BLOCK },
+	{ "do simd", "for simd", OMP_LOOP },
+	{ "do", "for", OMP_LOOP },
+	{ "simd", "simd", OMP_LOOP },
+	{ "sections", "sections", OMP_BLOCK },
+	{ "section", "section", OMP_BLOCK },
+	{ "single", "single", OMP_BLOCK },
+	{ "workshare", "single", OMP_BLOCK },
+	{ "master", "master", OMP_BLOCK },
+	{ "critical", "critical", OMP_BLOCK },
+	{ "ordered", "ordered", OMP_BLOCK },
+	{ "taskgroup", "taskgroup", OMP_BLOCK },
+	{ "taskwait", "taskwait", OMP_STANDALONE },
+	{ "taskyield", "taskyield", OMP_STANDALONE },
+	{ "task", "task", OMP_BLOCK },
+	{ "barrier", "barrier", OMP_STANDALONE },
+	{ "flush", "flush", OMP_STANDALONE },
+	{ "atomic", "atomic", OMP_STANDALONE },
+};
+
+// fortran reduction operators which are spelled differently in c++
+static const std::vector<std::tuple<std::string, std::string>> omp_reduction_operators = {
+	{ ".and.", "&&" },
+	{ ".or.", "||" },
+	{ "iand", "&" },
+	{ "ieor", "^" },
+	{ "ior", "|" },
+};
+
+static std::string map_omp_clauses(std::string clauses) {
+	/**************************************
+	* clauses are the same in fortran and c++(commas between clauses are allowed in both)
+	*	except for operators of `reduction(op:list)`
+	***************************************/
+	std::string::size_type p = 0;
+	while ((p = clauses.find("reduction", p)) != std::string::npos) {
+		std::string::size_type lp = clauses.find('(', p);
+		std::string::size_type colon = clauses.find(':', p);
+		p += 9;
+		if (lp == std::string::npos || colon == std::string::npos || lp > colon)
+		{
+			continue;
+		}
+		std::string op = boost::trim_copy(clauses.substr(lp + 1, colon - lp - 1));
+		for (const std::tuple<std::string, std::string> & pr : omp_reduction_operators)
+		{
+			if (op == std::get<0>(pr))
+			{
+				clauses.replace(lp + 1, colon - lp - 1, std::get<1>(pr));
+				break;
+			}
+		}
+	}
+	return clauses;
+}
+
+static bool parse_omp_directive(int pos, std::string text, OmpDirective & directive, bool & is_end) {
+	boost::to_lower(text);
+	boost::replace_all(text, "\t", " ");
+	while (text.find("  ") != std::string::npos) {
+		boost::replace_all(text, "  ", " ");
+	}
+	boost::trim(text);
+	is_end = boost::starts_with(text, "end");
+	if (is_end)
+	{
+		// both `end do` and `enddo` are valid
+		text = boost::trim_copy(text.substr(3));
+	}
+	for (const OmpConstruct & c : omp_constructs)
+	{
+		if (!boost::starts_with(text, c.construct))
+		{
+			continue;
+		}
+		std::string rest = text.substr(c.construct.size());
+		if (!rest.empty() && rest[0] != ' ' && rest[0] != '(' && rest[0] != ',')
+		{
+			// e.g. `do` and `double`
+			continue;
+		}
+		directive.pos = pos;
+		directive.kind = c.kind;
+		directive.construct = c.construct;
+		directive.pragma = c.pragma;
+		boost::trim(rest);
+		if (!rest.empty() && rest[0] == '(')
+		{
+			// `critical(name)`, `flush(list)`
+			std::string::size_type rp = rest.find(')');
+			if (rp != std::string::npos)
+			{
+				directive.pragma += rest.substr(0, rp + 1);
+				rest = boost::trim_copy(rest.substr(rp + 1));
+			}
+		}
+		directive.clauses = map_omp_clauses(rest);
+		return true;
+	}
+	return false;
+}
+
+void bind_omp_directives(const ParseNode & program) {
+	/**************************************
+	* bind every directive to the stmt whose first token is the first one after the directive
+	*	regardless of in which suite it is, e.g.
+	*	```
+	*	!$omp parallel do
+	*	do j = 1, n
+	*		do i = 1, n
+	*	```
+	*	is bound to `do j`, not `do i`
+	* `end` directives are never bound, their clauses(e.g. `nowait`) are moved to the matching directive
+	***************************************/
+	get_context().omp_directives.clear();
+	if (get_tokenizer_context().directives.empty())
+	{
+		return;
+	}
+	std::vector<int> stmt_pos;
+	std::function<void(const ParseNode &)> collect = [&](const ParseNode & pn) {
+		for (const ParseNode * ch : pn)
+		{
+			if (ch == nullptr)
+			{
+				continue;
+			}
+			if (pn.token_equals(TokenMeta::NT_SUITE) && !ch->token_equals(TokenMeta::Label))
+			{
+				int p = get_source_pos(*ch);
+				if (p != -1)
+				{
+					stmt_pos.push_back(p);
+				}
+			}
+			collect(*ch);
+		}
+	};
+	collect(program);
+	std::sort(stmt_pos.begin(), stmt_pos.end());
+
+	std::vector<OmpDirective> directives;
+	std::vector<int> opened; // index in `directives` of not yet ended OMP_BLOCK/OMP_LOOP
+	for (const std::tuple<int, std::string> & line : get_tokenizer_context().directives)
+	{
+		OmpDirective directive;
+		bool is_end;
+		if (!parse_omp_directive(std::get<0>(line), std::get<1>(line), directive, is_end))
+		{
+			print_error("Unsupported OpenMP directive: !$omp" + std::get<1>(line));
+			continue;
+		}
+		if (is_end)
+		{
+			auto match = std::find_if(opened.rbegin(), opened.rend(), [&](int x) {
+				return directives[x].construct == directive.construct;
+			});
+			if (match == opened.rend())
+			{
+				if (directive.kind == OMP_BLOCK)
+				{
+					print_error("Unmatched OpenMP directive: !$omp" + std::get<1>(line));
+				}
+				continue;
+			}
+			OmpDirective & begin = directives[*match];
+			if (!directive.clauses.empty())
+			{
+				begin.clauses += (begin.clauses.empty() ? "" : " ") + directive.clauses;
+			}
+			begin.region_end = directive.pos;
+			if (boost::ends_with(begin.construct, "sections") && directives[opened.back()].construct == "section")
+			{
+				directives[opened.back()].region_end = directive.pos;
+			}
+			opened.erase(match.base() - 1, opened.end());
+			continue;
+		}
+		if (directive.construct == "section" && !opened.empty() && directives[opened.back()].construct == "section")
+		{
+			// a `section` ends at the next `section`
+			directives[opened.back()].region_end = directive.pos;
+			opened.pop_back();
+		}
+		if (directive.kind != OMP_STANDALONE)
+		{
+			opened.push_back((int)directives.size());
+		}
+		directives.push_back(directive);
+	}
+
+	for (const OmpDirective & directive : directives)
+	{
+		auto iter = std::lower_bound(stmt_pos.begin(), stmt_pos.end(), directive.pos);
+		if (iter == stmt_pos.end())
+		{
+			print_error("OpenMP directive is not followed by any stmt: !$omp " + directive.construct);
+			continue;
+		}
+		get_context().omp_directives[*iter].push_back(directive);
+	}
+}
+
+bool omp_clauses_mention(const std::string & pragma, const std::string & name) {
+	std::string::size_type p = 0;
+	auto is_name_char = [](char ch) {
+		return isalnum((unsigned char)ch) || ch == '_';
+	};
+	while ((p = pragma.find(name, p)) != std::string::npos) {
+		std::string::size_type q = p + name.size();
+		if ((p == 0 || !is_name_char(pragma[p - 1])) && (q == pragma.size() || !is_name_char(pragma[q])))
+		{
+			return true;
+		}
+		p = q;
+	}
+	return false;
+}
+
+static void get_loop_variables(const ParseNode & stmt, std::vector<std::string> & names) {
+	if (stmt.token_equals(TokenMeta::NT_DORANGE) && stmt.length() > 0)
+	{
+		const std::string & name = stmt.get(0).get_what();
+		if (std::find(names.begin(), names.end(), name) == names.end())
+		{
+			names.push_back(name);
+		}
+	}
+	for (const ParseNode * ch : stmt)
+	{
+		if (ch != nullptr)
+		{
+			get_loop_variables(*ch, names);
+		}
+	}
+}
+
+static std::string map_private_arrays(FunctionInfo * finfo, std::string clauses) {
+	/**************************************
+	* the `private` copy of a fortran array has the shape of the original
+	*	, while in c++ it is default constructed, which gives a `farray` or `fautoarray` no element
+	*	, so arrays in `private(list)` are moved to a `firstprivate(list)`, which copies the original
+	***************************************/
+	std::string::size_type p = 0;
+	while ((p = clauses.find("private", p)) != std::string::npos) {
+		std::string::size_type lp = clauses.find_first_not_of(' ', p + 7);
+		std::string::size_type rp = clauses.find(')', p);
+		if ((p > 0 && (isalnum((unsigned char)clauses[p - 1]) || clauses[p - 1] == '_')) || lp == std::string::npos || clauses[lp] != '(' || rp == std::string::npos)
+		{
+			// e.g. `firstprivate`, `lastprivate`
+			p += 7;
+			continue;
+		}
+		std::string list = clauses.substr(lp + 1, rp - lp - 1);
+		std::vector<std::string> names, privates, arrays;
+		boost::split(names, list, boost::is_any_of(","));
+		for (std::string & name : names)
+		{
+			boost::trim(name);
+			VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, name);
+			// `real a(10)` keeps its shape in the entity until it is generated
+			if (vinfo != nullptr && (vinfo->is_array() || (vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable)))
+				&& !vinfo->desc.pointer.get())
+			{
+				arrays.push_back(name);
+			}
+			else {
+				privates.push_back(name);
+			}
+		}
+		std::string mapped = privates.empty() ? "" : "private(" + boost::join(privates, ", ") + ")";
+		if (!arrays.empty())
+		{
+			mapped += (mapped.empty() ? "" : " ") + std::string("firstprivate(") + boost::join(arrays, ", ") + ")";
+		}
+		clauses.replace(p, rp + 1 - p, mapped);
+		p += mapped.size();
+	}
+	return clauses;
+}
+
+static std::string gen_omp_pragma(FunctionInfo * finfo, const OmpDirective & directive, const std::vector<std::string> & loop_variables, const std::string & except) {
+	/**************************************
+	* in fortran, variables of sequential DO loops in a parallel or task construct are private
+	*	, while in c++ they are shared by default, so list them in a `private` clause
+	***************************************/
+	std::string pragma = "#pragma omp " + directive.pragma;
+	if (!directive.clauses.empty())
+	{
+		pragma += " " + map_private_arrays(finfo, directive.clauses);
+	}
+	std::vector<std::string> privates;
+	for (const std::string & name : loop_variables)
+	{
+		if (name != except && !omp_clauses_mention(directive.clauses, name))
+		{
+			privates.push_back(name);
+		}
+	}
+	if (!privates.empty())
+	{
+		pragma += " private(" + boost::join(privates, ", ") + ")";
+	}
+	return pragma;
+}
+
+void close_omp_regions(std::vector<OmpRegion> & regions, std::string & code, int pos) {
+	/**************************************
+	* close regions whose `end` directive is not after `pos`
+	*	, -1 closes all regions at the end of suite
+	***************************************/
+	while (!regions.empty() && (pos == -1 || (regions.back().end_pos != -1 && regions.back().end_pos <= pos))) {
+		OmpRegion & region = regions.back();
+		std::string pragma_line = region.pragma.empty() ? "" : region.pragma + "\n";
+		code = region.outer_code + pragma_line + "{\n" + tabber(code) + "}\n";
+		regions.pop_back();
+	}
+}
+
+void regen_omp_directives(FunctionInfo * finfo, ParseNode & suite, int stmt_index, std::vector<OmpRegion> & regions, std::string & code) {
+	if (get_context().omp_directives.empty() && regions.empty())
+	{
+		return;
+	}
+	ParseNode & stmt = suite.get(stmt_index);
+	int pos = get_source_pos(stmt);
+	if (pos == -1)
+	{
+		return;
+	}
+	auto iter = get_context().omp_directives.find(pos);
+	if (iter == get_context().omp_directives.end() || stmt.token_equals(TokenMeta::Label))
+	{
+		close_omp_regions(regions, code, pos);
+		return;
+	}
+	std::vector<OmpDirective> directives = iter->second;
+	get_context().omp_directives.erase(iter);
+	for (const OmpDirective & directive : directives)
+	{
+		// e.g. a `barrier` right before `end parallel` is bound to the stmt after the region
+		close_omp_regions(regions, code, directive.pos);
+		std::vector<std::string> loop_variables;
+		if (directive.kind == OMP_LOOP)
+		{
+			if (!stmt.token_equals(TokenMeta::NT_DORANGE))
+			{
+				print_error("OpenMP loop directive is not followed by a DO loop: !$omp " + directive.construct, stmt);
+				continue;
+			}
+			get_loop_variables(stmt, loop_variables);
+			get_context().omp_loop_pragma = gen_omp_pragma(finfo, directive, loop_variables, stmt.get(0).get_what());
+			int collapse = 1;
+			std::string::size_type p = directive.clauses.find("collapse(");
+			if (p != std::string::npos)
+			{
+				collapse = std::max(1, atoi(directive.clauses.c_str() + p + 9));
+			}
+			get_context().omp_collapse = collapse;
+		}
+		else if (directive.kind == OMP_BLOCK)
+		{
+			if (directive.construct == "parallel" || directive.construct == "parallel sections" || directive.construct == "task")
+			{
+				for (int i = stmt_index; i < suite.length(); i++)
+				{
+					int stmt_pos = get_source_pos(suite.get(i));
+					if (directive.region_end != -1 && stmt_pos > directive.region_end)
+					{
+						break;
+					}
+					get_loop_variables(suite.get(i), loop_variables);
+				}
+			}
+			std::string pragma = directive.pragma.empty() ? "" : gen_omp_pragma(finfo, directive, loop_variables, "");
+			regions.push_back(OmpRegion{ directive.region_end, pragma, code });
+			code = "";
+		}
+		else {
+			code += gen_omp_pragma(finfo, directive, loop_variables, "") + "\n";
+		}
+	}
+	close_omp_regions(regions, code, pos);
+}
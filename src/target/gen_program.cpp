@@ -32,6 +32,7 @@ void gen_fortran_program(const ParseNode & wrappers) {
 	std::string codes;
 	std::string main_code;
 	get_context().program_tree = wrappers;
+	bind_omp_directives(get_context().program_tree);
 
 	FunctionInfo * program_info = add_function("", "program", FunctionInfo());
 	ParseNode script_program = gen_token(Term{ TokenMeta::NT_SUITE , "" });
@@ -63,6 +64,7 @@ void gen_fortran_program(const ParseNode & wrappers) {
 		else if (wrapper.token_equals(TokenMeta::NT_PROGRAM_EXPLICIT)||wrapper.token_equals(TokenMeta::NT_BLOCKDATA))
 		{
             has_block_data_struct = wrapper.token_equals(TokenMeta::NT_BLOCKDATA);
+            program_info->global_scope = has_block_data_struct;
 			for (int j = 0; j < wrapper.get(0).length(); j++)
 			{
 				script_program.addchild(wrapper.get(0).get(j));
@@ -78,11 +80,13 @@ void gen_fortran_program(const ParseNode & wrappers) {
 			*	, before actually call `regen_function` or `regen_vardef` to any of the functions
 			*************/
 			FunctionInfo * finfo = add_function(get_context().current_module, variable_function.get_what(), FunctionInfo{});
+			set_function_prefix(finfo, wrapper);
 		}
         else if (wrapper.token_equals(TokenMeta::NT_MODULE))
         {
             minfo.is_set=true;
             minfo.outer_info = add_function(wrapper.get_what(),"",FunctionInfo{});
+            minfo.outer_info->global_scope = true;
             minfo.module_name = wrapper.get_what();
             ModuleInfo &minfo_alias = minfo;
             get_context().current_module = minfo.module_name;
@@ -92,7 +96,8 @@ void gen_fortran_program(const ParseNode & wrappers) {
                 if (node.token_equals(TokenMeta::NT_FUNCTIONDECLARE))
                 {
                     minfo_alias.func_decls_in_module.push_back(&node);
-                    add_function(get_context().current_module, node.get(1).get_what(),FunctionInfo{});
+                    FunctionInfo * finfo = add_function(get_context().current_module, node.get(1).get_what(),FunctionInfo{});
+                    set_function_prefix(finfo, node);
                 }
                 else if (node.token_equals(TokenMeta::NT_DERIVED_TYPE))
                 {
@@ -145,6 +150,17 @@ void gen_fortran_program(const ParseNode & wrappers) {
     if(minfo.is_set)
     {
         get_context().current_module = minfo.module_name;
+        /* types first, so components of a type are known in the functions using it, ref `is_soa_type` */
+        std::vector<ParseNode *> &type_decls_in_module = minfo.type_decls_in_module;
+        if(!type_decls_in_module.empty())
+        {
+            for(ParseNode *nodeptr:type_decls_in_module)
+            {
+                ParseNode & variable_type = nodeptr->get(0);
+                TypeInfo *tinfo = get_type(get_context().current_module,variable_type.get_what());
+                regen_derived_type_1(tinfo, *nodeptr);
+            }
+        }
         std::vector<ParseNode *> &func_decls_in_module = minfo.func_decls_in_module;
         if (!func_decls_in_module.empty())
         {
@@ -156,16 +172,6 @@ void gen_fortran_program(const ParseNode & wrappers) {
                 regen_function_1(finfo, node);
             }
         }
-        std::vector<ParseNode *> &type_decls_in_module = minfo.type_decls_in_module;
-        if(!type_decls_in_module.empty())
-        {
-            for(ParseNode *nodeptr:type_decls_in_module)
-            {
-                ParseNode & variable_type = nodeptr->get(0);
-                TypeInfo *tinfo = get_type(get_context().current_module,variable_type.get_what());
-                regen_derived_type_1(tinfo, *nodeptr);
-            }
-        }
     }
 
     // main program code
@@ -258,7 +264,7 @@ void gen_fortran_program(const ParseNode & wrappers) {
 
     // main program code
 	regen_all_variables_decl_str(program_info, script_program);
-	main_code = tabber(script_program.get_what());
+	main_code = tabber((has_block_data_struct ? "" : gen_profile_stmt("program")) + script_program.get_what());
     if(!has_block_data_struct)sprintf(codegen_buf, "int main()\n{\n%s\treturn 0;\n}", main_code.c_str());
     else sprintf(codegen_buf, "%s", main_code.c_str());
     main_code = codegen_buf;
@@ -289,6 +295,12 @@ void gen_fortran_program(const ParseNode & wrappers) {
             decl_per_func += ";\n";
 			forward_decls += sig;
 			forward_decls += ";\n";
+			if (finfo->elemental && !finfo->is_subroutine())
+			{
+				// the overload for array arguments, ref `forelemental`
+				decl_per_func += "FOR_ELEMENTAL(" + name + ")\n";
+				forward_decls += "FOR_ELEMENTAL(" + name + ")\n";
+			}
 		}
         if(!finfo->func_alias.empty())
         {
@@ -317,6 +329,11 @@ void gen_fortran_program(const ParseNode & wrappers) {
             forward_decls += signature;
             forward_decls += ";\n";
             decl_per_func += signature+";\n";
+            if (finfo->elemental && !finfo->is_subroutine())
+            {
+                forward_decls += "FOR_ELEMENTAL(" + name + ")\n";
+                decl_per_func += "FOR_ELEMENTAL(" + name + ")\n";
+            }
             if(!finfo->func_alias.empty())
             {
                 for(std::string sig: gen_func_alias_signature(finfo))
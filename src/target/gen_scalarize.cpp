@@ -0,0 +1,631 @@
+/*
+*   Calvin Neo
+*   Copyright (C) 2016  Calvin Neo <calvinneo@calvinneo.com>
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License along
+*   with this program; if not, write to the Free Software Foundation, Inc.,
+*   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "gen_common.h"
+#include <set>
+#include <algorithm>
+
+/**************************************
+* scalarization of whole array assignments like `a = b + c * d`
+*	farray operators make a temporary array for every operation of such a statement
+*	when every array of the statement has the same shape, which is known from its declaration,
+*	the statement is generated as one loop over the elements instead
+*	all arrays are indexed by the same flat position, so `a = a + b` is safe
+*	statements with allocatable, pointer or assumed shape arrays, sections, or calls
+*	other than elemental intrinsics and `elemental` functions, are left to the farray operators
+* `where` constructs are scalarized the same way, the masks and all branches run in one loop
+*	arrays in a `where` must conform to the mask(7.5.3.1), so their declared shapes are not compared
+* reductions like `sum(a(2:n) * b(:, j), mask = a(2:n) > 0)` are one loop over the positions of the sections
+*	every array and section is read in place through a `forstrided` view, ref `regen_inline_reduction`
+***************************************/
+
+namespace {
+	// intrinsics which have a scalar overload of the same name in C++
+	const std::set<std::string> elemental_intrinsics = {
+		"abs", "acos", "asin", "atan", "cos", "cosh", "exp", "log", "log10", "sin", "sinh", "sqrt", "tan", "tanh"
+	};
+
+	struct ScalarizeScan {
+		FunctionInfo * finfo;
+		std::string shape;
+		std::vector<std::string> arrays; // in order of appearance, without repetition
+		bool conformable = false; // shapes are known to conform
+		std::string index; // if not empty, arrays are read by `forelement(a, index)` instead of flat pointers
+		bool strided = false; // if true, arrays and sections of rank `rank` are read by `forstrided` views declared in `views`
+		int rank = 0; // the rank of the first array or section if `strided`, whose size is `shape`
+		std::vector<std::string> views;
+	};
+
+	bool is_number(const std::string & str) {
+		return !str.empty() && std::all_of(str.begin(), str.end(), [](char c) { return c >= '0' && c <= '9'; });
+	}
+
+	std::string bound_key(const ParseNode & x) {
+		if (x.length() == 0)
+		{
+			return x.get_what();
+		}
+		std::string key = "(" + std::to_string(x.get_token());
+		for (const ParseNode * child : x)
+		{
+			key += " " + bound_key(*child);
+		}
+		return key + ")";
+	}
+
+	std::string extent_key(const ParseNode & lb, const ParseNode & ub) {
+		// `a(10)` and `b(0:9)` conform
+		if (is_number(lb.get_what()) && is_number(ub.get_what()) && lb.length() == 0 && ub.length() == 0)
+		{
+			return std::to_string(std::atoi(ub.get_what().c_str()) - std::atoi(lb.get_what().c_str()) + 1);
+		}
+		return bound_key(lb) + ":" + bound_key(ub);
+	}
+}
+
+static const ParseNode * get_declared_dims(VariableInfo * vinfo) {
+	if (vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable))
+	{
+		// `real a(10)` keeps its shape in the entity
+		return &vinfo->entity_variable.get(0).get(1);
+	}
+	else if (vinfo->desc.slice.is_initialized()) {
+		return &vinfo->desc.slice.get();
+	}
+	return nullptr;
+}
+
+bool get_fixed_shape(VariableInfo * vinfo, std::string & shape) {
+	// returns false if the shape is not known from the declaration
+	if (vinfo->desc.allocatable.get() || vinfo->desc.pointer.get() || vinfo->commonblock_name != "")
+	{
+		return false;
+	}
+	const ParseNode * dims = get_declared_dims(vinfo);
+	if (dims == nullptr || dims->length() == 0)
+	{
+		return false;
+	}
+	shape = "";
+	for (const ParseNode * dim : *dims)
+	{
+		std::string extent;
+		if (dim->token_equals(TokenMeta::NT_SLICE))
+		{
+			if (dim->length() != 2 || dim->get(0).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY) || dim->get(1).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY))
+			{
+				// assumed shape `a(:)`, or deferred shape
+				return false;
+			}
+			extent = extent_key(dim->get(0), dim->get(1));
+		}
+		else if (dim->token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY) || dim->get_what() == "*") {
+			return false;
+		}
+		else {
+			ParseNode one = gen_token(Term{ TokenMeta::META_INTEGER, "1" });
+			extent = extent_key(one, *dim);
+		}
+		shape += (shape.empty() ? "" : ", ") + extent;
+	}
+	return true;
+}
+
+namespace {
+	bool add_strided_view(ScalarizeScan & scan, VariableInfo * vinfo, const std::string & name, int rank, const std::string & slices, std::string & code) {
+		// reads the array `name`, or its section of `rank` dimensions if `slices` is not empty, by a view
+		const ParseNode * dims = get_declared_dims(vinfo);
+		if (dims == nullptr || (slices.empty() && dims->length() != rank) || vinfo->desc.pointer.get() || is_soa_type(vinfo->type.get_what()))
+		{
+			return false;
+		}
+		// `arrays` are the arguments of the views, so a section read twice has one view
+		std::string source = slices.empty() ? name : name + ", {" + slices + "}";
+		std::vector<std::string>::iterator found = std::find(scan.arrays.begin(), scan.arrays.end(), source);
+		std::string view = name + "_s" + (slices.empty() ? "" : to_string(found - scan.arrays.begin()));
+		if (scan.rank == 0)
+		{
+			// all arrays and sections conform to the first one
+			scan.rank = rank;
+			scan.shape = view + ".size";
+		}
+		if (rank != scan.rank)
+		{
+			return false;
+		}
+		if (found == scan.arrays.end())
+		{
+			sprintf(codegen_buf, "const auto %s = forstrided<%d>(%s);", view.c_str(), rank, source.c_str());
+			scan.views.push_back(string(codegen_buf));
+			scan.arrays.push_back(source);
+		}
+		code = view + "(reduce_k)";
+		return true;
+	}
+
+	bool scalarize_exp(ScalarizeScan & scan, const ParseNode & exp, std::string & code) {
+		// generates the element `k` of `exp` into `code`, `exp` has been regenerated
+		if (exp.token_equals(TokenMeta::NT_EXPRESSION) && (exp.length() == 2 || exp.length() == 3))
+		{
+			const ParseNode & op = exp.get(exp.length() - 1);
+			if (!op.token_equals(TokenMeta::Add, TokenMeta::Minus, TokenMeta::Multiply, TokenMeta::Divide, TokenMeta::Power
+				, TokenMeta::Neg, TokenMeta::Pos, TokenMeta::LB) && !op.token_equals(TokenMeta::EQ, TokenMeta::NEQ, TokenMeta::GT
+				, TokenMeta::GE, TokenMeta::LT, TokenMeta::LE) && !op.token_equals(TokenMeta::AndAnd, TokenMeta::OrOr, TokenMeta::EQV, TokenMeta::NEQV))
+			{
+				return false;
+			}
+			std::string x, y;
+			if (!scalarize_exp(scan, exp.get(0), x) || (exp.length() == 3 && !scalarize_exp(scan, exp.get(1), y)))
+			{
+				return false;
+			}
+			sprintf(codegen_buf, op.get_what().c_str(), x.c_str(), y.c_str());
+			code = string(codegen_buf);
+			return true;
+		}
+		else if (is_literal(exp)) {
+			code = exp.get_what();
+			return !exp.token_equals(TokenMeta::String);
+		}
+		else if (exp.token_equals(TokenMeta::UnknownVariant) && exp.length() == 0) {
+			VariableInfo * vinfo = get_variable(get_context().current_module, scan.finfo->local_name, exp.get_what());
+			if (vinfo == nullptr || vinfo->desc.pointer.get() || vinfo->commonblock_name != "")
+			{
+				return false;
+			}
+			if (!vinfo->is_array() && !(vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable)))
+			{
+				// scalars are the same for every element
+				code = exp.get_what();
+				return true;
+			}
+			if (scan.strided)
+			{
+				const ParseNode * dims = get_declared_dims(vinfo);
+				return dims != nullptr && add_strided_view(scan, vinfo, exp.get_what(), dims->length(), "", code);
+			}
+			std::string shape;
+			if (!scan.conformable && (!get_fixed_shape(vinfo, shape) || shape != scan.shape))
+			{
+				return false;
+			}
+			if (std::find(scan.arrays.begin(), scan.arrays.end(), exp.get_what()) == scan.arrays.end())
+			{
+				scan.arrays.push_back(exp.get_what());
+			}
+			code = scan.index.empty() ? exp.get_what() + "_flat[" + scan.arrays[0] + "_k]" : "forelement(" + exp.get_what() + ", " + scan.index + ")";
+			return true;
+		}
+		else if (scan.strided && exp.token_equals(TokenMeta::NT_FUCNTIONARRAY) && exp.length() == 2 && exp.get(1).token_equals(TokenMeta::NT_DIMENSLICE)) {
+			// a section `a(2:n, j)`, whose rank is the number of its slices
+			VariableInfo * vinfo = get_variable(get_context().current_module, scan.finfo->local_name, exp.get(0).get_what());
+			const ParseNode & argtable = exp.get(1);
+			if (vinfo == nullptr || vinfo->commonblock_name != "" || get_declared_dims(vinfo) == nullptr || get_declared_dims(vinfo)->length() != argtable.length())
+			{
+				return false;
+			}
+			int rank = (int)std::count_if(argtable.begin(), argtable.end(), [](const ParseNode * x) { return x->token_equals(TokenMeta::NT_SLICE); });
+			std::string slices = make_str_list(argtable.begin(), argtable.end(), [](const ParseNode * x) { return "{" + x->get_what() + "}"; });
+			return add_strided_view(scan, vinfo, exp.get(0).get_what(), rank, slices, code);
+		}
+		else if (exp.token_equals(TokenMeta::NT_FUCNTIONARRAY) && exp.length() == 2 && exp.get(1).token_equals(TokenMeta::NT_ARGTABLE_PURE)) {
+			const std::string & name = exp.get(0).get_what();
+			if (get_variable(get_context().current_module, scan.finfo->local_name, name) != nullptr)
+			{
+				if (!scan.strided)
+				{
+					return false;
+				}
+				// an element `w(i)` is the same for every position of a reduction, which doesn't write any array
+				code = exp.get_what();
+				return true;
+			}
+			FunctionInfo * callee = get_function(get_context().current_module, name);
+			if (callee != nullptr ? !callee->elemental || callee->is_subroutine() : !elemental_intrinsics.count(name) || exp.get(1).length() != 1)
+			{
+				return false;
+			}
+			// an `elemental` function is called with the elements, so it is not `FOR_ELEMENTAL`, and can be inlined into the loop
+			std::string args;
+			for (const ParseNode * arg : exp.get(1))
+			{
+				std::string x;
+				if (!scalarize_exp(scan, *arg, x))
+				{
+					return false;
+				}
+				args += (args.empty() ? "" : ", ") + x;
+			}
+			code = name + "(" + args + ")";
+			return true;
+		}
+		return false;
+	}
+
+	bool is_array_assignment(const ParseNode & stmt) {
+		// `a = exp`, `a` is a name
+		if (!(stmt.token_equals(TokenMeta::NT_STATEMENT) && stmt.length() > 0))
+		{
+			return false;
+		}
+		const ParseNode & exp = stmt.get(0);
+		return exp.token_equals(TokenMeta::NT_EXPRESSION) && exp.length() == 3 && exp.get(2).token_equals(TokenMeta::Let)
+			&& exp.get(2).get_what() == "%s = %s" && exp.get(0).token_equals(TokenMeta::UnknownVariant) && exp.get(0).length() == 0;
+	}
+
+	// an assignment to a section `a(1:n) = exp` is `assign_forslice(a, exp, {{1, n}})`, ref `regen_function_array`
+	const std::string section_let = "assign_forslice(%s, %s, ";
+
+	bool is_section_assignment(const ParseNode & stmt) {
+		if (!(stmt.token_equals(TokenMeta::NT_STATEMENT) && stmt.length() > 0))
+		{
+			return false;
+		}
+		const ParseNode & exp = stmt.get(0);
+		return exp.token_equals(TokenMeta::NT_EXPRESSION) && exp.length() == 3 && exp.get(2).token_equals(TokenMeta::Let)
+			&& exp.get(2).get_what().compare(0, section_let.size(), section_let) == 0;
+	}
+
+	bool scalarize_where(ScalarizeScan & scan, std::set<std::string> & written, const ParseNode & where, std::string & code);
+
+	bool scalarize_where_suite(ScalarizeScan & scan, std::set<std::string> & written, const ParseNode & suite, std::string & code) {
+		code = "";
+		for (const ParseNode * stmtptr : suite)
+		{
+			const ParseNode & stmt = *stmtptr;
+			std::string stmt_str;
+			if (stmt.token_equals(TokenMeta::NT_WHERE))
+			{
+				if (!scalarize_where(scan, written, stmt, stmt_str))
+				{
+					return false;
+				}
+				code += stmt_str;
+			}
+			else if (is_array_assignment(stmt)) {
+				const ParseNode & lhs = stmt.get(0).get(0);
+				std::string lhs_str, rhs_str;
+				if (!scalarize_exp(scan, lhs, lhs_str) || lhs_str == lhs.get_what() || !scalarize_exp(scan, stmt.get(0).get(1), rhs_str))
+				{
+					// the left side is a scalar, or a part can't be scalarized
+					return false;
+				}
+				written.insert(lhs.get_what());
+				code += lhs_str + " = " + rhs_str + ";\n";
+			}
+			else if (!(stmt.token_equals(TokenMeta::NT_STATEMENT) && stmt.length() == 0)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool scalarize_where(ScalarizeScan & scan, std::set<std::string> & written, const ParseNode & where, std::string & code) {
+		// generates `if (mask) {...} else if (mask) {...} else {...}` for one element
+		std::string mask_str, suite_str;
+		if (!scalarize_exp(scan, where.get(0), mask_str) || scan.arrays.empty() || !scalarize_where_suite(scan, written, where.get(1), suite_str))
+		{
+			return false;
+		}
+		code = "if (" + mask_str + ") {\n" + tabber(suite_str) + "}\n";
+		for (const ParseNode * elsewhere = &where.get(2); elsewhere->token_equals(TokenMeta::NT_ELSEWHERE); elsewhere = &elsewhere->get(2))
+		{
+			if (!scalarize_where_suite(scan, written, elsewhere->get(1), suite_str))
+			{
+				return false;
+			}
+			if (elsewhere->get(0).token_equals(TokenMeta::NT_DUMMY))
+			{
+				code += "else {\n" + tabber(suite_str) + "}\n";
+			}
+			else {
+				if (!scalarize_exp(scan, elsewhere->get(0), mask_str))
+				{
+					return false;
+				}
+				code += "else if (" + mask_str + ") {\n" + tabber(suite_str) + "}\n";
+			}
+		}
+		return true;
+	}
+
+	void regen_where_exp(FunctionInfo * finfo, ParseNode & where) {
+		regen_exp(finfo, where.get(0));
+		for (ParseNode * suite = &where.get(1), * next = &where.get(2); ; suite = &next->get(1), next = &next->get(2))
+		{
+			for (ParseNode * stmtptr : *suite)
+			{
+				ParseNode & stmt = *stmtptr;
+				if (stmt.token_equals(TokenMeta::NT_WHERE))
+				{
+					regen_where_exp(finfo, stmt);
+				}
+				else if (stmt.token_equals(TokenMeta::NT_STATEMENT) && stmt.length() > 0) {
+					regen_exp(finfo, stmt.get(0));
+				}
+			}
+			if (!next->token_equals(TokenMeta::NT_ELSEWHERE))
+			{
+				break;
+			}
+			if (!next->get(0).token_equals(TokenMeta::NT_DUMMY))
+			{
+				regen_exp(finfo, next->get(0));
+			}
+		}
+	}
+
+	void regen_where_masked(FunctionInfo * finfo, const ParseNode & where, const std::string & outer, int & mask_id, std::string & extent, std::string & code) {
+		/****************
+		* a `where` which can't be scalarized as a whole
+		* every mask is evaluated into a `farray<bool>` once, and every assignment is a masked loop
+		****************/
+		std::string pending = outer; // elements not selected by any previous mask
+		const ParseNode * branch = &where;
+		while (true) {
+			std::string cond = pending;
+			const ParseNode & mask = branch->get(0);
+			if (!mask.token_equals(TokenMeta::NT_DUMMY))
+			{
+				std::string mask_name = "where_mask_" + to_string(mask_id++);
+				ScalarizeScan scan{ finfo };
+				scan.conformable = true;
+				scan.index = "where_k";
+				std::string mask_str;
+				if (scalarize_exp(scan, mask, mask_str) && !scan.arrays.empty())
+				{
+					sprintf(codegen_buf, "const farray<bool> %s = forwhere_mask(%s, [&](fsize_t where_k){ return %s; });\n", mask_name.c_str(), scan.arrays[0].c_str(), mask_str.c_str());
+				}
+				else {
+					sprintf(codegen_buf, "const farray<bool> %s = %s;\n", mask_name.c_str(), mask.get_what().c_str());
+				}
+				code += codegen_buf;
+				if (extent.empty())
+				{
+					extent = mask_name;
+				}
+				cond = (pending.empty() ? "" : pending + " && ") + "forelement(" + mask_name + ", where_k)";
+				pending = (pending.empty() ? "" : pending + " && ") + "!forelement(" + mask_name + ", where_k)";
+			}
+			for (const ParseNode * stmtptr : branch->get(1))
+			{
+				const ParseNode & stmt = *stmtptr;
+				if (stmt.token_equals(TokenMeta::NT_WHERE))
+				{
+					regen_where_masked(finfo, stmt, cond, mask_id, extent, code);
+				}
+				else if (is_array_assignment(stmt) || is_section_assignment(stmt)) {
+					std::string lhs_str = stmt.get(0).get(0).get_what();
+					std::string section;
+					if (is_section_assignment(stmt))
+					{
+						// the section is a view of the array, or is copied in and copied out, ref `forsection`
+						const std::string & let = stmt.get(0).get(2).get_what();
+						std::string slices = let.substr(section_let.size(), let.size() - section_let.size() - 1);
+						VariableInfo * vinfo = check_implicit_variable(finfo, lhs_str);
+						sprintf(codegen_buf, "auto where_section = forsection(%s, %s);\nfarray<%s> & where_lhs = where_section;\n"
+							, lhs_str.c_str(), slices.c_str(), vinfo->type.get_what().c_str());
+						section = codegen_buf;
+						lhs_str = "where_lhs";
+					}
+					ScalarizeScan scan{ finfo };
+					scan.conformable = true;
+					scan.index = "where_k";
+					std::string rhs_str;
+					if (scalarize_exp(scan, stmt.get(0).get(1), rhs_str))
+					{
+						sprintf(codegen_buf, "for(fsize_t where_k = 0; where_k < %s.flatsize(); where_k++){\n\tif (%s) {\n\t\t%s.begin()[where_k] = %s;\n\t}\n}\n"
+							, extent.c_str(), cond.c_str(), lhs_str.c_str(), rhs_str.c_str());
+					}
+					else {
+						// the right side is evaluated before any element is assigned
+						sprintf(codegen_buf, "{\n\tconst auto where_value = %s;\n\tfor(fsize_t where_k = 0; where_k < %s.flatsize(); where_k++){\n\t\tif (%s) {\n\t\t\t%s.begin()[where_k] = forelement(where_value, where_k);\n\t\t}\n\t}\n}\n"
+							, stmt.get(0).get(1).get_what().c_str(), extent.c_str(), cond.c_str(), lhs_str.c_str());
+					}
+					code += section.empty() ? string(codegen_buf) : "{\n" + tabber(section + codegen_buf) + "}\n";
+				}
+				else if (!(stmt.token_equals(TokenMeta::NT_STATEMENT) && stmt.length() == 0)) {
+					fatal_error("Only array assignments and `where` are supported in `where`", stmt);
+				}
+			}
+			if (!branch->get(2).token_equals(TokenMeta::NT_ELSEWHERE))
+			{
+				break;
+			}
+			branch = &branch->get(2);
+		}
+	}
+}
+
+void regen_where(FunctionInfo * finfo, ParseNode & where) {
+	regen_where_exp(finfo, where);
+	ScalarizeScan scan{ finfo };
+	scan.conformable = true;
+	std::set<std::string> written;
+	std::string code;
+	if (scalarize_where(scan, written, where, code))
+	{
+		const std::string & first = scan.arrays[0];
+		std::string decl;
+		for (const std::string & name : scan.arrays)
+		{
+			bool is_written = written.count(name) > 0;
+			sprintf(codegen_buf, "%s * %s_flat = %s.%s();\n", is_written ? "auto" : "const auto", name.c_str(), name.c_str(), is_written ? "begin" : "cbegin");
+			decl += codegen_buf;
+		}
+		sprintf(codegen_buf, "for(fsize_t %s_k = 0; %s_k < %s.flatsize(); %s_k++){\n%s}\n"
+			, first.c_str(), first.c_str(), first.c_str(), first.c_str(), tabber(code).c_str());
+		code = decl + string(codegen_buf);
+	}
+	else {
+		int mask_id = 0;
+		std::string extent;
+		code = "";
+		regen_where_masked(finfo, where, "", mask_id, extent, code);
+	}
+	where.get_what() = "{\n" + tabber(code) + "}";
+}
+
+bool regen_scalarized_assignment(FunctionInfo * finfo, ParseNode & stmt) {
+	/****************
+	* `stmt` is a regenerated assignment
+	* returns false and keeps `stmt` if it can't be scalarized
+	****************/
+	ParseNode & exp = stmt.get(0);
+	if (!(exp.token_equals(TokenMeta::NT_EXPRESSION) && exp.length() == 3 && exp.get(2).token_equals(TokenMeta::Let)
+		&& exp.get(2).get_what() == "%s = %s"))
+	{
+		return false;
+	}
+	ParseNode & lhs = exp.get(0);
+	if (!(lhs.token_equals(TokenMeta::UnknownVariant) && lhs.length() == 0))
+	{
+		return false;
+	}
+	VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, lhs.get_what());
+	ScalarizeScan scan{ finfo };
+	if (vinfo == nullptr || !(vinfo->is_array() || (vinfo->entity_variable.length() > 0 && is_function_array(vinfo->entity_variable)))
+		|| !get_fixed_shape(vinfo, scan.shape))
+	{
+		return false;
+	}
+	scan.arrays.push_back(lhs.get_what());
+	std::string rhs;
+	if (!scalarize_exp(scan, exp.get(1), rhs))
+	{
+		return false;
+	}
+	std::string k = lhs.get_what() + "_k";
+	std::string code;
+	for (size_t i = 0; i < scan.arrays.size(); i++)
+	{
+		sprintf(codegen_buf, "%s * %s_flat = %s.%s();\n", i == 0 ? "auto" : "const auto", scan.arrays[i].c_str(), scan.arrays[i].c_str(), i == 0 ? "begin" : "cbegin");
+		code += codegen_buf;
+	}
+	sprintf(codegen_buf, "for(fsize_t %s = 0; %s < %s.flatsize(); %s++){\n\t%s_flat[%s] = %s;\n}\n"
+		, k.c_str(), k.c_str(), lhs.get_what().c_str(), k.c_str(), lhs.get_what().c_str(), k.c_str(), rhs.c_str());
+	code += codegen_buf;
+	stmt.get_what() = "{\n" + tabber(code) + "}";
+	return true;
+}
+
+bool regen_inline_reduction(FunctionInfo * finfo, ParseNode & callable, const std::string & head_name) {
+	/****************
+	* `sum`, `product`, `maxval`, `minval` of an array with an optional mask, or `count`, `any`, `all` of a mask
+	*	, whose arguments have been regenerated
+	* a whole array or a section without mask is reduced in place, like `forsum(a, {{2, n}})`
+	* any other elemental expression of arrays and sections, and its mask, is reduced in one loop, ref `forreduce_strided`
+	* returns false if there is a `dim`, which is left to `regen_function_array`
+	****************/
+	static const std::set<std::string> masked_reductions = { "forsum", "forproduct", "formaxval", "forminval" };
+	static const std::set<std::string> mask_reductions = { "forcount", "forany", "forall" };
+	bool is_masked = masked_reductions.count(head_name) > 0;
+	const std::string name = callable.get(0).to_string();
+	if ((!is_masked && !mask_reductions.count(head_name)) || callable.get(0).length() != 0
+		|| get_variable(get_context().current_module, finfo->local_name, name) != nullptr || get_function(get_context().current_module, name) != nullptr)
+	{
+		return false;
+	}
+	const ParseNode * array = nullptr, * mask = nullptr;
+	bool positional_mask = false;
+	for (const ParseNode * arg : callable.get(1))
+	{
+		if (arg->token_equals(TokenMeta::NT_KEYVALUE) && !arg->get(1).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY))
+		{
+			const std::string key = arg->get(0).to_string();
+			if (key == (is_masked ? "array" : "mask") && array == nullptr)
+			{
+				array = &arg->get(1);
+			}
+			else if (key == "mask" && is_masked && mask == nullptr) {
+				mask = &arg->get(1);
+			}
+			else {
+				// `dim`
+				return false;
+			}
+		}
+		else {
+			const ParseNode & x = arg->token_equals(TokenMeta::NT_KEYVALUE) ? arg->get(0) : *arg;
+			if (array == nullptr)
+			{
+				array = &x;
+			}
+			else if (is_masked && mask == nullptr) {
+				// `sum(a, a > 0)` has a mask, `sum(a, 1)` has a `dim`
+				mask = &x;
+				positional_mask = true;
+			}
+			else {
+				return false;
+			}
+		}
+	}
+	if (array == nullptr)
+	{
+		return false;
+	}
+	if (positional_mask)
+	{
+		ScalarizeScan scan{ finfo };
+		scan.strided = true;
+		std::string x;
+		if (!scalarize_exp(scan, *mask, x) || scan.views.empty())
+		{
+			return false;
+		}
+	}
+	std::string code;
+	VariableInfo * vinfo = array->length() == 2 && array->get(0).length() == 0 ? get_variable(get_context().current_module, finfo->local_name, array->get(0).get_what()) : nullptr;
+	if (mask == nullptr && vinfo != nullptr && array->token_equals(TokenMeta::NT_FUCNTIONARRAY) && array->get(1).token_equals(TokenMeta::NT_DIMENSLICE)
+		&& !is_soa_type(vinfo->type.get_what()))
+	{
+		// `sum(a(2:n))` doesn't copy the section
+		const ParseNode & argtable = array->get(1);
+		std::string slices = make_str_list(argtable.begin(), argtable.end(), [](const ParseNode * x) { return "{" + x->get_what() + "}"; });
+		sprintf(codegen_buf, "%s(%s, {%s})", head_name.c_str(), array->get(0).get_what().c_str(), slices.c_str());
+		code = string(codegen_buf);
+	}
+	else if (mask == nullptr && array->token_equals(TokenMeta::UnknownVariant) && array->length() == 0) {
+		code = head_name + "(" + array->get_what() + ")";
+	}
+	else {
+		ScalarizeScan scan{ finfo };
+		scan.strided = true;
+		std::string element, mask_str;
+		if (scalarize_exp(scan, *array, element) && !scan.views.empty() && (mask == nullptr || scalarize_exp(scan, *mask, mask_str)))
+		{
+			std::string position = "const fsize_t(&reduce_k)[" + to_string(scan.rank) + "]";
+			std::string decl;
+			for (const std::string & view : scan.views)
+			{
+				decl += view + " ";
+			}
+			sprintf(codegen_buf, "[&]{ %sreturn %s_strided(%s, [&](%s){ return %s; }%s); }()", decl.c_str(), head_name.c_str(), scan.shape.c_str(), position.c_str(), element.c_str()
+				, mask == nullptr ? "" : (", [&](" + position + "){ return " + mask_str + "; }").c_str());
+			code = string(codegen_buf);
+		}
+		else {
+			// a temporary array is made, but an absent `dim` is not passed as `None`
+			code = head_name + "(" + array->get_what() + (mask == nullptr ? "" : ", " + mask->get_what()) + ")";
+		}
+	}
+	callable.fs.CurrentTerm = Term{ TokenMeta::NT_FUCNTIONARRAY, code };
+	return true;
+}
@@ -19,52 +19,325 @@
 
 #include "gen_common.h"
 
+/**************************************
+* `select case`
+*	the selector is evaluated once, into `select_value`
+*	an integer selector whose cases are constants is a `switch`, a range of at most `max_case_range` values
+*	is expanded to `case` labels, the other cases are conditions under `default`
+*	a `character` selector of length 1 is a `switch` on its first character
+*	a `character` selector whose cases are literals is a `switch` on the index of its case,
+*	looked up in a static hash table, ref `forselect_case`
+*	otherwise, or if an `exit` in a case would `break` the `switch`, it is an `if` chain
+***************************************/
+
+namespace {
+	const long long max_case_range = 64;
+
+	struct CaseItem {
+		ParseNode * from;
+		ParseNode * to; // nullptr for a single value
+	};
+
+	void get_case_items(ParseNode & dimen_slice, std::vector<CaseItem> & items) {
+		// `case (1, 3:5)` is a NT_DIMENSLICE of NT_SLICE and `exp`, and the flattened NT_ARGTABLE_PURE
+		for (ParseNode * px : dimen_slice)
+		{
+			if (px->token_equals(TokenMeta::NT_DIMENSLICE, TokenMeta::NT_ARGTABLE_PURE))
+			{
+				get_case_items(*px, items);
+			}
+			else if (px->token_equals(TokenMeta::NT_SLICE)) {
+				items.push_back(CaseItem{ &px->get(0), &px->get(1) });
+			}
+			else {
+				items.push_back(CaseItem{ px, nullptr });
+			}
+		}
+	}
+
+	bool has_break(const ParseNode & stmt) {
+		// `exit` of an enclosing loop, which is `break;`
+		if (stmt.token_equals(TokenMeta::Break))
+		{
+			return stmt.length() == 0 || !stmt.get(0).token_equals(TokenMeta::META_WORD);
+		}
+		else if (stmt.token_equals(TokenMeta::NT_DO, TokenMeta::NT_DORANGE, TokenMeta::NT_WHILE, TokenMeta::NT_CONCURRENT, TokenMeta::NT_FORALL)) {
+			return false;
+		}
+		for (const ParseNode * px : stmt)
+		{
+			if (has_break(*px))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool get_char_literal(const ParseNode & x, long long & value) {
+		// `"a"`
+		if (!is_str(x))
+		{
+			return false;
+		}
+		const string & str = x.get_what();
+		if (str.size() != 3 || str[0] != '"' || str[2] != '"' || str[1] == '\\' || str[1] == '\'')
+		{
+			return false;
+		}
+		value = (unsigned char)str[1];
+		return true;
+	}
+
+	string gen_case_label(long long value, bool is_char) {
+		if (is_char && value >= 0x20 && value < 0x7f && value != '\\' && value != '\'')
+		{
+			sprintf(codegen_buf, "'%c'", (char)value);
+		}
+		else {
+			sprintf(codegen_buf, "%lld", value);
+		}
+		return string(codegen_buf);
+	}
+
+	string gen_str_key(const ParseNode & x) {
+		// compared as if padded with blanks, so trailing blanks are not a part of the key
+		string str = x.get_what();
+		while (str.size() > 2 && str[str.size() - 2] == ' ')
+		{
+			str.erase(str.size() - 2, 1);
+		}
+		return str;
+	}
+
+	bool is_char_selector(FunctionInfo * finfo, const ParseNode & exp) {
+		if (!exp.token_equals(TokenMeta::UnknownVariant))
+		{
+			return false;
+		}
+		VariableInfo * vinfo = get_variable(get_context().current_module, finfo->local_name, exp.get_what());
+		if (vinfo == nullptr)
+		{
+			vinfo = get_variable(get_context().current_module, "", exp.get_what());
+		}
+		if (vinfo == nullptr || !vinfo->type.token_equals(TokenMeta::String, TokenMeta::String_Decl))
+		{
+			return false;
+		}
+		// `character*8` is not merged into `vinfo->desc` until `regen_vardef`
+		VariableDesc desc = vinfo->desc;
+		VariableDescAttr * type_attr = dynamic_cast<VariableDescAttr *>(vinfo->type.attr);
+		if (type_attr != nullptr)
+		{
+			desc.merge(type_attr->desc);
+		}
+		if (vinfo->entity_variable.length() > 0)
+		{
+			// `character c*8`
+			const ParseNode & entity_variable_name = vinfo->entity_variable.get(0);
+			if (entity_variable_name.length() == 3 && entity_variable_name.get(2).token_equals(TokenMeta::Multiply))
+			{
+				return entity_variable_name.get(1).get_what() == "1";
+			}
+		}
+		return desc.kind.get() <= 1 && !desc.slice.is_initialized();
+	}
+
+	bool get_case_labels(FunctionInfo * finfo, const std::vector<std::vector<CaseItem>> & items, bool is_char
+		, std::vector<std::vector<long long>> & labels, std::vector<bool> & is_label) {
+		// the value of every case is a constant
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			labels[i].clear();
+			is_label[i] = true;
+			for (const CaseItem & x : items[i])
+			{
+				long long from, to;
+				ConstValue v1, v2;
+				if (is_char)
+				{
+					if (!get_char_literal(*x.from, from) || (x.to != nullptr && !get_char_literal(*x.to, to)))
+					{
+						return false;
+					}
+				}
+				else {
+					if (!eval_const_exp(finfo, *x.from, v1) || !v1.is_int || (x.to != nullptr && (!eval_const_exp(finfo, *x.to, v2) || !v2.is_int)))
+					{
+						return false;
+					}
+					from = v1.i;
+					to = v2.i;
+				}
+				if (x.to == nullptr)
+				{
+					to = from;
+				}
+				if (to - from >= max_case_range)
+				{
+					is_label[i] = false;
+				}
+				for (long long v = from; is_label[i] && v <= to; v++)
+				{
+					labels[i].push_back(v);
+				}
+			}
+		}
+		return true;
+	}
+
+	string gen_case_condition(const CaseItem & item) {
+		if (item.to == nullptr)
+		{
+			sprintf(codegen_buf, "select_value == %s", item.from->get_what().c_str());
+		}
+		else {
+			sprintf(codegen_buf, "(select_value >= %s && select_value <= %s)", item.from->get_what().c_str(), item.to->get_what().c_str());
+		}
+		return string(codegen_buf);
+	}
+
+	string gen_if_chain(const std::vector<std::vector<CaseItem>> & conditions, const std::vector<ParseNode *> & bodies, ParseNode * default_body) {
+		string code;
+		for (size_t i = 0; i < bodies.size(); i++)
+		{
+			string cond = make_str_list(conditions[i].begin(), conditions[i].end(), [&](const CaseItem & item) {
+				return gen_case_condition(item);
+			}, " || ");
+			sprintf(codegen_buf, "%sif(%s){\n%s}\n", code.empty() ? "" : "else ", cond.c_str(), tabber(bodies[i]->to_string()).c_str());
+			code += string(codegen_buf);
+		}
+		if (default_body != nullptr)
+		{
+			if (code.empty())
+			{
+				code = default_body->to_string();
+			}
+			else {
+				sprintf(codegen_buf, "else {\n%s}\n", tabber(default_body->to_string()).c_str());
+				code += string(codegen_buf);
+			}
+		}
+		return code;
+	}
+}
+
 void regen_select(FunctionInfo * finfo, ParseNode & select_stmt) {
 	ParseNode & exp = select_stmt.get(0);
-	ParseNode & case_stmt = select_stmt.get(1); 
+	ParseNode & case_stmt = select_stmt.get(1);
 	select_stmt.fs.CurrentTerm = Term{ TokenMeta::NT_SELECT, "" };
-	string case_default;
-	bool first_if = true;
+	regen_exp(finfo, exp);
+
+	std::vector<std::vector<CaseItem>> items;
+	std::vector<ParseNode *> bodies;
+	ParseNode * default_body = nullptr;
+	bool can_switch = true;
 	for (ParseNode * item : case_stmt)
 	{
-		ParseNode & case_stmt_elem = *item;
-		ParseNode & dimen_slice = case_stmt_elem.get(0);
-		ParseNode & body = case_stmt_elem.get(1);
+		ParseNode & dimen_slice = item->get(0);
+		ParseNode & body = item->get(1);
 		regen_suite(finfo, body, true);
-
+		can_switch = can_switch && !has_break(body);
 		if (dimen_slice.token_equals(TokenMeta::NT_DUMMY))
 		{
-			sprintf(codegen_buf, "else {\n%s}\n", tabber(body.to_string()).c_str());
-			case_default = string(codegen_buf);
+			// `case default` may be anywhere
+			default_body = &body;
+			continue;
+		}
+		items.push_back(std::vector<CaseItem>());
+		if (dimen_slice.token_equals(TokenMeta::NT_DIMENSLICE, TokenMeta::NT_ARGTABLE_PURE))
+		{
+			get_case_items(dimen_slice, items.back());
 		}
 		else {
-			string conditions;
-			if (dimen_slice.token_equals(TokenMeta::NT_DIMENSLICE)) {
-				// NT_DIMENSLICE
-				conditions = make_str_list(dimen_slice.begin(), dimen_slice.end(), [&](ParseNode * px) {
-					ParseNode & x = *px;
-					ParseNode & from = x.get(0);
-					ParseNode & to = x.get(1);
-					sprintf(codegen_buf, "(%s >= %s && %s < %s)", exp.to_string().c_str(), from.to_string().c_str(), exp.to_string().c_str(), to.to_string().c_str());
-					return string(codegen_buf);
-				}, "||");
+			items.back().push_back(CaseItem{ &dimen_slice, nullptr });
+		}
+		for (CaseItem & x : items.back())
+		{
+			// a string literal is kept as `"a"`, not `SS("a")`
+			for (ParseNode * px : { x.from, x.to })
+			{
+				if (px != nullptr && !is_str(*px))
+				{
+					regen_exp(finfo, *px);
+				}
 			}
-			else if (dimen_slice.token_equals(TokenMeta::NT_ARGTABLE_PURE)) {
-				// NT_ARGTABLE_PURE
-				conditions = make_str_list(dimen_slice.begin(), dimen_slice.end(), [&](ParseNode * px) {
-					ParseNode & x = *px;
-					sprintf(codegen_buf, "%s == %s", exp.to_string().c_str(), x.to_string().c_str());
-					return string(codegen_buf);
-				}, "||");
+		}
+		bodies.push_back(&body);
+	}
+
+	// kind of `switch`, and its `case` labels
+	std::vector<std::vector<long long>> labels(bodies.size());
+	std::vector<bool> is_label(bodies.size(), true);
+	bool is_char = can_switch && is_char_selector(finfo, exp) && get_case_labels(finfo, items, true, labels, is_label);
+	bool is_integer = can_switch && !is_char && get_case_labels(finfo, items, false, labels, is_label);
+	bool is_hash = can_switch && !is_char && !is_integer && std::all_of(items.begin(), items.end(), [](const std::vector<CaseItem> & x) {
+		return std::all_of(x.begin(), x.end(), [](const CaseItem & y) { return y.to == nullptr && is_str(*y.from); });
+	});
+
+	string code;
+	if (is_char || is_integer || is_hash)
+	{
+		string cases;
+		std::vector<std::vector<CaseItem>> conditions;
+		std::vector<ParseNode *> condition_bodies;
+		for (size_t i = 0; i < bodies.size(); i++)
+		{
+			string case_labels;
+			if (is_hash)
+			{
+				sprintf(codegen_buf, "case %d:\n", (int)i + 1);
+				case_labels = string(codegen_buf);
 			}
-			if (first_if) {
-				sprintf(codegen_buf, "if(%s){\n%s}\n", conditions.c_str(), tabber(body.to_string()).c_str());
-				first_if = false;
+			else if (is_label[i]) {
+				for (long long v : labels[i])
+				{
+					sprintf(codegen_buf, "case %s:\n", gen_case_label(v, is_char).c_str());
+					case_labels += string(codegen_buf);
+				}
 			}
 			else {
-				sprintf(codegen_buf, "else if(%s){\n%s}\n", conditions.c_str(), tabber(body.to_string()).c_str());
+				conditions.push_back(items[i]);
+				condition_bodies.push_back(bodies[i]);
+				continue;
+			}
+			if (!case_labels.empty())
+			{
+				// a case of an empty range is never selected
+				sprintf(codegen_buf, "%s\t{\n%s\t\tbreak;\n\t}\n", case_labels.c_str(), tabber(tabber(bodies[i]->to_string())).c_str());
+				cases += string(codegen_buf);
 			}
 		}
-		select_stmt.get_what() += string(codegen_buf);
+		string default_code = gen_if_chain(conditions, condition_bodies, default_body);
+		if (!default_code.empty())
+		{
+			sprintf(codegen_buf, "default:\n\t{\n%s\t\tbreak;\n\t}\n", tabber(tabber(default_code)).c_str());
+			cases += string(codegen_buf);
+		}
+		if (is_hash)
+		{
+			std::vector<string> keys;
+			for (size_t i = 0; i < bodies.size(); i++)
+			{
+				for (const CaseItem & x : items[i])
+				{
+					sprintf(codegen_buf, "{ %s, %d }", gen_str_key(*x.from).c_str(), (int)i + 1);
+					keys.push_back(string(codegen_buf));
+				}
+			}
+			string table = make_str_list(keys.begin(), keys.end(), [&](const string & x) { return x; });
+			sprintf(codegen_buf, "static const forselect_table select_cases{ %s };\nswitch (forselect_case(select_cases, select_value)) {\n%s}\n"
+				, table.c_str(), cases.c_str());
+		}
+		else {
+			sprintf(codegen_buf, "switch (%s) {\n%s}\n", is_char ? "forselect_char(select_value)" : "select_value", cases.c_str());
+		}
+		code = string(codegen_buf);
+	}
+	else {
+		code = gen_if_chain(items, bodies, default_body);
 	}
-}
\ No newline at end of file
+	// `select_value` of a `character` selector is a reference, not a copy
+	sprintf(codegen_buf, "{\n\tconst auto %sselect_value = %s;\n%s}\n", is_integer ? "" : "& ", exp.to_string().c_str(), tabber(code).c_str());
+	select_stmt.get_what() = string(codegen_buf);
+}
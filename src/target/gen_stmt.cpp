@@ -30,8 +30,15 @@ void regen_simple_stmt(FunctionInfo * finfo, ParseNode & stmt) {
 		*	are all types of exp. refer `is_exp`
 		*************/
 		ParseNode & exp = stmt.get(0);
+		if (regen_arraybuilder_assignment(finfo, stmt))
+		{
+			return;
+		}
 		regen_exp(finfo, exp);
-		stmt.get_what() = exp.get_what() + ";";
+		if (!regen_scalarized_assignment(finfo, stmt))
+		{
+			stmt.get_what() = exp.get_what() + ";";
+		}
 	}
 }
 
@@ -94,6 +101,7 @@ std::string regen_stmt(FunctionInfo * finfo, ParseNode & stmt) {
 	*	compound_stmt				NT_IF, ...
 	*	implicit_stmt				ConfigImplicit
 	*	allocate_stmt				NT_ALLOCATE_STMT
+	*	data_stmt					NT_DATA
 	*===============
 	* control_stmt include:
 	*	pause_stmt, stop_stmt, YY_CONTINUE, YY_RETURN, jump_stmt(YY_CYCLE, YY_EXIT, YY_GOTO)
@@ -122,20 +130,10 @@ std::string regen_stmt(FunctionInfo * finfo, ParseNode & stmt) {
             else{
                 /** GOTO stmt ref https://docs.oracle.com/cd/E19957-01/805-4939/6j4m0vn9l/index.html
                  *  for90.y:1267, added 2 children, parameter and exp
+                 *  arithmetic if has the same children
                  */
-                ParseNode &goto_stmt = stmt.get(0);
-                ParseNode &options = goto_stmt.get(0);
-                ParseNode &choice = goto_stmt.get(1);
-                for(int i=1; i<=options.child.size(); i++){
-                    sprintf(codegen_buf, "if (((int)%s)==%d) goto LABEL_%s_%s;", choice.get_what().c_str(), i,
-                            finfo->local_name.c_str(), options.get(i-1).get_what().c_str());
-                    newsuitestr += string(codegen_buf);
-                    newsuitestr += '\n';
-                }
-                sprintf(codegen_buf, "continue;");
-                newsuitestr += string(codegen_buf);
+                newsuitestr += regen_computed_goto(finfo, stmt.get(0));
                 newsuitestr += '\n';
-
             }
 		}
         else if (stmt.get(0).token_equals(TokenMeta::Break))
@@ -245,11 +243,10 @@ std::string regen_stmt(FunctionInfo * finfo, ParseNode & stmt) {
             {
                 /* `real(a)`, using constant as type selector */
                 ParseNode &var = type_nospec.get(0);
-                VariableInfo* varInfo = get_variable(get_context().current_module,finfo->local_name,var.get_what());
-                if(varInfo->desc.constant.get())
+                ConstValue kind;
+                if(eval_const_exp(finfo, var, kind) && kind.is_int)
                 {
-                    int kind = std::stoi(varInfo->vardef_node->get(2).get(1).get_what().c_str());
-                    get_variabledesc_attr(vardescattr).kind = kind;
+                    get_variabledesc_attr(vardescattr).kind = (int)kind.i;
                 }
             }
             if(entity_variable.child[1]!=nullptr&&!entity_variable.get(1).child.empty())
@@ -453,6 +450,26 @@ std::string regen_stmt(FunctionInfo * finfo, ParseNode & stmt) {
 		newsuitestr += stmt.get_what();
 		newsuitestr += '\n';
 	}
+	else if (stmt.token_equals(TokenMeta::NT_CONCURRENT)) {
+		regen_do_concurrent(finfo, stmt);
+		newsuitestr += stmt.get_what();
+		newsuitestr += '\n';
+	}
+	else if (stmt.token_equals(TokenMeta::NT_FORALL)) {
+		regen_forall(finfo, stmt);
+		newsuitestr += stmt.get_what();
+		newsuitestr += '\n';
+	}
+	else if (stmt.token_equals(TokenMeta::NT_WHERE)) {
+		regen_where(finfo, stmt);
+		newsuitestr += stmt.get_what();
+		newsuitestr += '\n';
+	}
+	else if (stmt.token_equals(TokenMeta::NT_DATA)) {
+		regen_data(finfo, stmt);
+		newsuitestr += stmt.get_what();
+		newsuitestr += '\n';
+	}
 	else if (stmt.token_equals(TokenMeta::NT_SELECT)) {
 		regen_select(finfo, stmt);
 		newsuitestr += stmt.get_what();
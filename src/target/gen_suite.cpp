@@ -35,6 +35,138 @@ std::vector<ParseNode *> get_all_commons(FunctionInfo * finfo, ParseNode & suite
 	return declared_commons;
 }
 
+int get_source_pos(const ParseNode & stmt) {
+	/****
+	* `parse_line` is updated by the tokenizer after lookahead, and compound stmts(e.g. `if`, `do`)
+	*	take the position of their ending token, so both are not accurate enough
+	* instead, use the smallest `parse_pos` in the subtree(the first token of the stmt)
+	* returns -1 if `stmt` is generated and has no position
+	****/
+	int first_pos = -1;
+	std::function<void(const ParseNode &)> find_first = [&](const ParseNode & pn) {
+		if (pn.fs.parse_len > 0 && (first_pos == -1 || pn.fs.parse_pos < first_pos))
+		{
+			first_pos = pn.fs.parse_pos;
+		}
+		for (const ParseNode * ch : pn)
+		{
+			if (ch != nullptr)
+			{
+				find_first(*ch);
+			}
+		}
+	};
+	find_first(stmt);
+	return first_pos;
+}
+
+int get_source_line(const ParseNode & stmt) {
+	/****
+	* map the first token of `stmt` to a line of `global_code`
+	* returns 0 if `stmt` is generated and has no position
+	****/
+	// the index is built once per translation, `reset_context` clears it
+	std::vector<int> & line_start = get_context().line_start;
+	const std::string & code = get_context().global_code;
+	if (line_start.empty())
+	{
+		line_start.push_back(0);
+		for (int i = 0; i < (int)code.size(); i++)
+		{
+			if (code[i] == '\n') {
+				line_start.push_back(i + 1);
+			}
+		}
+	}
+	int first_pos = get_source_pos(stmt);
+	if (first_pos == -1)
+	{
+		return 0;
+	}
+	return (int)(std::upper_bound(line_start.begin(), line_start.end(), first_pos) - line_start.begin());
+}
+
+std::string gen_line_directive(const ParseNode & stmt) {
+	/****
+	* generate `#line N "file"` before the code of `stmt`
+	*	, so perf/gprof/sanitizers attribute generated code to the fortran source line
+	****/
+	if (!get_context().parse_config.line_directive)
+	{
+		return "";
+	}
+	int line = get_source_line(stmt);
+	if (line == 0)
+	{
+		return "";
+	}
+	const std::string & filename = get_context().parse_config.filename;
+	if (filename.empty())
+	{
+		// the source is read from stdin, so there is no file name to refer to
+		sprintf(codegen_buf, "#line %d\n", line);
+	}
+	else {
+		sprintf(codegen_buf, "#line %d \"%s\"\n", line, add_escape_char(filename).c_str());
+	}
+	return string(codegen_buf);
+}
+
+static void regen_suite_stmts(FunctionInfo * finfo, ParseNode & oldsuite, int begin, int end, std::vector<OmpRegion> & omp_regions, std::string & newsuitestr) {
+	/****
+	* regen code of stmts [begin, end) of `oldsuite`
+	*	, and restructure `goto`s into loops and conditionals, ref `get_goto_region`
+	****/
+	for (int i = begin; i < end; i++)
+	{
+		ParseNode & stmt = oldsuite.get(i);
+		regen_omp_directives(finfo, oldsuite, i, omp_regions, newsuitestr);
+		GotoRegion region;
+		if (omp_regions.empty() && get_goto_region(finfo, oldsuite, i, end, region))
+		{
+			std::string body, else_body;
+			regen_suite_stmts(finfo, oldsuite, region.body_begin, region.body_end, omp_regions, body);
+			if (region.body_end > region.body_begin && oldsuite.get(region.body_end - 1).token_equals(TokenMeta::Label))
+			{
+				// a label of the `goto` which is the end of the region
+				body += "nop();\n";
+			}
+			newsuitestr += region.head + "\n" + tabber(body);
+			if (region.else_begin != -1)
+			{
+				regen_suite_stmts(finfo, oldsuite, region.else_begin, region.else_end, omp_regions, else_body);
+				newsuitestr += "}\nelse {\n" + tabber(else_body);
+			}
+			newsuitestr += region.tail + "\n";
+			i = region.end - 1;
+		}
+		else if (stmt.token_equals(TokenMeta::Label)) {
+			int j = i + 1;
+			if (j < oldsuite.length())
+			{
+				// make sure j in within bound
+				const ParseNode & next_stmt = oldsuite.get(j);
+				if (next_stmt.token_equals(TokenMeta::NT_FORMAT) || is_label_restructured(finfo, stmt.get_what()))
+				{
+					// handled in the prev loop, or all `goto`s to the label are restructured
+				}
+				else {
+					sprintf(codegen_buf, "LABEL_%s_%s:\n", finfo->local_name.c_str(), stmt.get_what().c_str());
+					newsuitestr += string(codegen_buf);
+				}
+			}
+		}
+		else {
+			string stmtstr = regen_stmt(finfo, stmt);
+			if (!stmtstr.empty() && !stmt.token_equals(TokenMeta::Comments))
+			{
+				newsuitestr += gen_line_directive(stmt);
+			}
+			newsuitestr += stmtstr;
+		}
+	}
+}
+
 void regen_suite(FunctionInfo * finfo, ParseNode & oldsuite, bool is_partial) {
 	/****
 	* this function regen code of `suite` node and
@@ -42,6 +174,13 @@ void regen_suite(FunctionInfo * finfo, ParseNode & oldsuite, bool is_partial) {
 	* 2. regen_vardef
 	****/
 	std::string newsuitestr;
+	std::vector<OmpRegion> omp_regions;
+	int gotos = 0;
+	if (!is_partial)
+	{
+		get_context().goto_restructured = 0;
+		gotos = log_goto_refs(finfo, oldsuite);
+	}
 
 	// regen format
 	if (oldsuite.token_equals(TokenMeta::NT_SUITE))
@@ -79,29 +218,8 @@ void regen_suite(FunctionInfo * finfo, ParseNode & oldsuite, bool is_partial) {
 	// regen other stmt
 	if (oldsuite.token_equals(TokenMeta::NT_SUITE))
 	{
-		for (int i = 0; i < oldsuite.length(); i++)
-		{
-			ParseNode & stmt = oldsuite.get(i);
-			if (stmt.token_equals(TokenMeta::Label)) {
-				int j = i + 1;
-				if (j < oldsuite.length())
-				{
-					// make sure j in within bound
-					const ParseNode & next_stmt = oldsuite.get(j);
-					if (next_stmt.token_equals(TokenMeta::NT_FORMAT))
-					{
-						// handled in the prev loop
-					}
-					else {
-						sprintf(codegen_buf, "LABEL_%s_%s:\n", finfo->local_name.c_str(), stmt.get_what().c_str());
-						newsuitestr += string(codegen_buf);
-					}
-				}
-			}
-			else {
-				newsuitestr += regen_stmt(finfo, stmt);
-			}
-		}
+		regen_suite_stmts(finfo, oldsuite, 0, oldsuite.length(), omp_regions, newsuitestr);
+		close_omp_regions(omp_regions, newsuitestr);
 	}
 	else
 	{
@@ -123,7 +241,10 @@ void regen_suite(FunctionInfo * finfo, ParseNode & oldsuite, bool is_partial) {
 	}
 	if (!is_partial)
 	{
-
+		if (gotos > 0)
+		{
+			report_goto(finfo, gotos);
+		}
 		regen_all_variables(finfo, oldsuite);
 		//newsuitestr = regen_all_variables_decl_str(finfo, oldsuite) + newsuitestr;
 	}
@@ -255,7 +376,13 @@ void regen_all_variables_decl_str(FunctionInfo * finfo, ParseNode & oldsuite) {
 				VariableDesc & desc = commonblock_vinfo->desc;
 				ParseNode & entity_variable = commonblock_vinfo->entity_variable;
 				std::string common_varname = "_" + to_string(vinfo->commonblock_index + 1);
-				if (commonblock_vinfo->desc.reference == true)
+				std::string common_view = gen_common_view(finfo, vinfo);
+				if (common_view != "")
+				{
+					// a view of the storage of this common block
+					sprintf(codegen_buf, "%s", common_view.c_str());
+				}
+				else if (commonblock_vinfo->desc.reference == true)
 				{
 					sprintf(codegen_buf, "%s %s = BLOCK_%s.%s;\n", gen_qualified_typestr(type, desc, false).c_str()
 						, local_name.c_str(), vinfo->commonblock_name.c_str(), common_varname.c_str());
@@ -45,6 +45,91 @@ ParseNode gen_type(Term typeterm) {
 	return gen_type(gen_token(typeterm));
 }
 
+/**************************************
+* REAL kind model
+*	`real(4)`, `real*4` is `float`, `real(8)`, `double precision` is `double`, `real(16)` is `long double`
+*	`real` without a kind is of `parse_config.default_real_kind`
+***************************************/
+Term gen_real_term(int kind) {
+	if (kind <= 0)
+	{
+		kind = get_context().parse_config.default_real_kind;
+	}
+	if (kind <= 4) {
+		return Term{ TokenMeta::Float, "float" };
+	}
+	else if (kind <= 8) {
+		return Term{ TokenMeta::Double, "double" };
+	}
+	else {
+		return Term{ TokenMeta::LongDouble, "long double" };
+	}
+}
+
+int get_real_kind(const ParseNode & type, const VariableDesc & vardesc) {
+	// kind of a REAL variable, 0 if it is not REAL
+	if (type.token_equals(TokenMeta::Float_Decl))
+	{
+		return vardesc.kind.isdirty() ? vardesc.kind.get() : get_context().parse_config.default_real_kind;
+	}
+	else if (type.token_equals(TokenMeta::Float)) {
+		return 4;
+	}
+	else if (type.token_equals(TokenMeta::Double, TokenMeta::Double_Decl)) {
+		return 8;
+	}
+	else if (type.token_equals(TokenMeta::LongDouble, TokenMeta::LongDouble_Decl)) {
+		return 16;
+	}
+	return 0;
+}
+
+Term gen_real_literal_term(const std::string & number, int kind) {
+	// `number` is a C++ floating literal without suffix
+	Term term = gen_real_term(kind);
+	if (term.token == TokenMeta::Float) {
+		term.what = number + "f";
+	}
+	else if (term.token == TokenMeta::LongDouble) {
+		term.what = number + "L";
+	}
+	else {
+		term.what = number;
+	}
+	return term;
+}
+
+ParseNode gen_real_literal(const std::string & lit) {
+	/**************************************
+	* R413 real-literal-constant is significand [exponent-letter exponent] [_ kind-param]
+	*	the tokenizer keeps exponent letter `d` and the kind-param, e.g. `1.0d-3`, `.93E7_QUAD`, `2.0_8`
+	*	a named kind-param is a child of the literal, and is resolved in `regen_exp`
+	***************************************/
+	std::string::size_type underscore = lit.find('_');
+	std::string number = lit.substr(0, underscore);
+	std::string kind_param = underscore == std::string::npos ? "" : lit.substr(underscore + 1);
+	int kind = 0;
+	std::string::size_type d = number.find_first_of("dD");
+	if (d != std::string::npos)
+	{
+		// double precision real constant
+		number[d] = 'e';
+		kind = 8;
+	}
+	if (!kind_param.empty() && std::all_of(kind_param.begin(), kind_param.end(), [](char ch) { return ch >= '0' && ch <= '9'; }))
+	{
+		kind = std::atoi(kind_param.c_str());
+		kind_param = "";
+	}
+	ParseNode newnode = gen_token(gen_real_literal_term(number, kind));
+	if (!kind_param.empty())
+	{
+		newnode.fs.CurrentTerm.what = number;
+		newnode.addchild(gen_token(Term{ TokenMeta::UnknownVariant, kind_param }));
+	}
+	return newnode;
+}
+
 ParseNode gen_implicit_type(FunctionInfo * finfo, std::string name) {
 	if (name.size() > 0)
 	{	
@@ -59,11 +144,11 @@ ParseNode gen_implicit_type(FunctionInfo * finfo, std::string name) {
 		if (tok == TokenMeta::Int64_Decl) tname = "int64_t";
 		if (tok == TokenMeta::Double_Decl) tname = "double";
 		if (tok == TokenMeta::LongDouble_Decl) tname = "long double";
-		if (tok == TokenMeta::Float_Decl) tname = "float";
+		if (tok == TokenMeta::Float_Decl) tname = gen_real_term(0).what;
 		return gen_type(Term{ tok, tname });
 	}
 	else {
-		return gen_type(Term{ TokenMeta::Float_Decl, "double" });
+		return gen_type(Term{ TokenMeta::Float_Decl, gen_real_term(0).what });
 	}
 }
 
@@ -71,7 +156,11 @@ void promote_type(ParseNode & type_nospec, VariableDesc & vardesc) {
 	// reset type according to kind
 	// merge type_spec and variable_desc attr
 	vardesc.merge(dynamic_cast<VariableDescAttr *>(type_nospec.attr)->desc);
-	if (vardesc.kind.isdirty()) {
+	if (type_nospec.token_equals(TokenMeta::Float)) {
+		// `real` without kind is also promoted, ref `gen_real_term`
+		type_nospec.fs.CurrentTerm = gen_real_term(vardesc.kind.isdirty() ? vardesc.kind.get() : 0);
+	}
+	else if (vardesc.kind.isdirty()) {
 		if (type_nospec.token_equals(TokenMeta::Int)) {
 			if (vardesc.kind == 1) {
 				type_nospec.fs.CurrentTerm = Term{ TokenMeta::Int8, "int8_t" };
@@ -86,18 +175,50 @@ void promote_type(ParseNode & type_nospec, VariableDesc & vardesc) {
 				type_nospec.fs.CurrentTerm = Term{ TokenMeta::Int64, "int64_t" };
 			}
 		}
-		else if (type_nospec.token_equals(TokenMeta::Float)) {
-			if (vardesc.kind < 4) {
-				type_nospec.fs.CurrentTerm = Term{ TokenMeta::Float, "float" };
-			}
-			else if (vardesc.kind == 4) {
-				type_nospec.fs.CurrentTerm = Term{ TokenMeta::Double, "double" };
-			}
-			else if (vardesc.kind == 8) {
-				type_nospec.fs.CurrentTerm = Term{ TokenMeta::LongDouble, "long double" };
-			}
+	}
+}
+
+bool is_arithmetic_type(const ParseNode & type_spec) {
+	// types which are cheaper to pass by value than by reference
+	return type_spec.token_equals(TokenMeta::Int, TokenMeta::Int8, TokenMeta::Int16, TokenMeta::Int32, TokenMeta::Int64
+		, TokenMeta::Float, TokenMeta::Double, TokenMeta::LongDouble, TokenMeta::Bool);
+}
+
+bool is_soa_type(const std::string & type_name) {
+	/*****************
+	* true if arrays of the derived type are stored as struct-of-arrays, ref `gen_soa_definition`
+	*	the type is chosen by `--soa` or a `!dir$ soa` directive
+	*	, and all its components must be scalars
+	*****************/
+	if (get_context().soa_types.find(type_name) == get_context().soa_types.end())
+	{
+		return false;
+	}
+	// the type may be defined in another module, which is used by the current one
+	string module_name = get_context().current_module;
+	for (const std::pair<const std::string, TypeInfo *> & pr : get_context().types)
+	{
+		if (get_type(module_name, type_name) == nullptr && pr.second->local_name == type_name)
+		{
+			module_name = pr.first.substr(0, pr.first.size() - type_name.size() - 2);
 		}
 	}
+	TypeInfo * tinfo = get_type(module_name, type_name);
+	if (tinfo == nullptr)
+	{
+		return false;
+	}
+	bool all_scalar = true;
+	int components = 0;
+	forall_variable_in_function(module_name, tinfo->local_name, [&](const std::pair<std::string, VariableInfo *> & p) {
+		VariableInfo * vinfo = p.second;
+		components++;
+		if (vinfo->is_array() || is_function_array(vinfo->entity_variable) || vinfo->desc.pointer.get() || vinfo->desc.cray_pointer.get())
+		{
+			all_scalar = false;
+		}
+	});
+	return all_scalar && components > 0;
 }
 
 std::string gen_qualified_typestr(const ParseNode & type_spec, VariableDesc & vardesc, bool in_paramtable) {
@@ -123,10 +244,15 @@ std::string gen_qualified_typestr(const ParseNode & type_spec, VariableDesc & va
 		}
 		else {
 			if(vardesc.inout_reference){
-				var_pattern = "%s &&";
+				// `INOUT(X)` binds a variable to it, ref `forarg`
+				var_pattern = "%s &";
 			}
 			else if (vardesc.reference) {
-				if (vardesc.constant) {
+				if (vardesc.constant && in_paramtable && !vardesc.slice.is_initialized() && is_arithmetic_type(type_spec)) {
+					// `intent(in)` scalars of arithmetic types are passed by value
+					var_pattern = "const %s";
+				}
+				else if (vardesc.constant) {
 					var_pattern = "const %s &";
 				}
 				else {
@@ -161,7 +287,10 @@ std::string gen_qualified_typestr(const ParseNode & type_spec, VariableDesc & va
 	if (vardesc.slice.is_initialized())
 	{
 		// if slice attr is presented, this variable is an array of type_spec 
-		if (get_context().parse_config.usefarray) {
+		if (get_context().parse_config.usefarray && is_soa_type(base_typename)) {
+			base_typename += "_soa";
+		}
+		else if (get_context().parse_config.usefarray) {
 			sprintf(codegen_buf, "farray<%s>", base_typename.c_str());
 			base_typename = string(codegen_buf);
 		}
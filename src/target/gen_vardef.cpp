@@ -18,6 +18,7 @@
 */
 
 #include "gen_common.h"
+#include <climits>
 
 static bool isnumber(std::string str) {
 	return std::accumulate(str.begin(), str.end(), true, [](bool x, char y) {
@@ -25,6 +26,17 @@ static bool isnumber(std::string str) {
 	});
 }
 
+static std::string int_literal_str(const std::string & str) {
+	// returns the integer literal in `str`, like `-2` from `(-2)`, or "" if `str` is not a literal
+	std::string x = str;
+	if (x.size() > 2 && x.front() == '(' && x.back() == ')')
+	{
+		x = x.substr(1, x.size() - 2);
+	}
+	std::string digits = (x.size() > 1 && x[0] == '-') ? x.substr(1) : x;
+	return (digits.size() > 0 && isnumber(digits)) ? x : "";
+}
+
 SliceBoundInfo get_lbound_size_from_slice(FunctionInfo * finfo, ParseNode & dimen_slice) {
 	/*****************
 	* because the usage of `boost::optional<ParseNode> desc.slice`
@@ -55,9 +67,10 @@ SliceBoundInfo get_lbound_size_from_slice(FunctionInfo * finfo, ParseNode & dime
 			, [](const ParseNode * x) {
 				if (x->token_equals(TokenMeta::NT_SLICE))
 				{
-					if (isnumber(x->get(0).get_what()))
+					std::string l_str = int_literal_str(x->get(0).get_what());
+					if (l_str != "")
 					{
-						int l = std::atoi(x->get(0).get_what().c_str());
+						int l = std::atoi(l_str.c_str());
 						return to_string(l);
 					}
 					else {
@@ -73,12 +86,13 @@ SliceBoundInfo get_lbound_size_from_slice(FunctionInfo * finfo, ParseNode & dime
 			, [](const ParseNode * x) {
 				if (x->token_equals(TokenMeta::NT_SLICE))
 				{
-					if (isnumber(x->get(1).get_what()) && isnumber(x->get(0).get_what()))
+					std::string u_str = int_literal_str(x->get(1).get_what()), l_str = int_literal_str(x->get(0).get_what());
+					if (u_str != "" && l_str != "")
 					{
 						// we can do this computing at "compile" time
-						int u = std::atoi(x->get(1).get_what().c_str());
-						int l = std::atoi(x->get(0).get_what().c_str());
-						return to_string(u);
+						int u = std::atoi(u_str.c_str());
+						int l = std::atoi(l_str.c_str());
+						return to_string(u - l + 1);
 					}
 					else {
 						// if there's variables
@@ -97,6 +111,112 @@ SliceBoundInfo get_lbound_size_from_slice(FunctionInfo * finfo, ParseNode & dime
 }
 
 
+// larger arrays stay on the heap, so a local array can't overflow the stack
+static const long long static_array_max_flatsize = 4096;
+
+static bool is_local_array(FunctionInfo * finfo, VariableInfo * vinfo) {
+	/*****************
+	* false if the array must be a `farray`, because
+	*	its shape is decided by others(allocatable, pointer, dummy arguments), or
+	*	it is a function result, a common block member or a constant, or
+	*	it is stored as struct-of-arrays, ref `is_soa_type`
+	*****************/
+	const VariableDesc & desc = vinfo->desc;
+	if (!get_context().parse_config.usefarray || vinfo->declared || vinfo->commonblock_name != "" || is_soa_type(vinfo->type.get_what()))
+	{
+		return false;
+	}
+	if (desc.allocatable.get() || desc.pointer.get() || desc.cray_pointer.get() || desc.target.get() || desc.optional.get()
+		|| desc.reference.get() || desc.inout_reference.get() || desc.constant.get())
+	{
+		return false;
+	}
+	if (finfo != nullptr && (vinfo->local_name == finfo->result_name
+		|| std::find(finfo->funcdesc.paramtable_info.begin(), finfo->funcdesc.paramtable_info.end(), vinfo->local_name) != finfo->funcdesc.paramtable_info.end()))
+	{
+		return false;
+	}
+	return true;
+}
+
+std::string gen_static_array_typestr(FunctionInfo * finfo, VariableInfo * vinfo, ParseNode & slice_node) {
+	/*****************
+	* an array whose bounds are all literals, like `real a(10, 0:4)`, is a `fstaticarray`
+	*	its elements are stored inside the object, so it is never allocated on the heap
+	* returns "" if the array must be a `farray`, ref `is_local_array`
+	*****************/
+	if (!is_local_array(finfo, vinfo))
+	{
+		return "";
+	}
+	long long flatsize;
+	string dims = gen_static_dims_str(finfo, slice_node, flatsize);
+	if (dims == "" || flatsize > static_array_max_flatsize)
+	{
+		return "";
+	}
+	sprintf(codegen_buf, "fstaticarray<%s%s>", vinfo->type.get_what().c_str(), dims.c_str());
+	return string(codegen_buf);
+}
+
+std::string gen_auto_array_typestr(FunctionInfo * finfo, VariableInfo * vinfo, ParseNode & slice_node) {
+	/*****************
+	* any other local array of a subprogram, like `real work(n)`, is a `fautoarray`
+	*	its elements are allocated in the `farena` of the thread, so a call doesn't allocate on the heap
+	* returns "" if the array must be a `farray`, ref `is_local_array`, or it is saved, so it outlives the arena
+	*****************/
+	if (!is_local_array(finfo, vinfo) || finfo == nullptr || finfo->global_scope || finfo == get_function("", "program") || vinfo->desc.save.get())
+	{
+		return "";
+	}
+	for (ParseNode * slice : slice_node)
+	{
+		if (slice->token_equals(TokenMeta::NT_SLICE) && (slice->length() != 2 || slice->get(0).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY)))
+		{
+			return "";
+		}
+	}
+	SliceBoundInfo shape = get_lbound_size_from_slice(finfo, slice_node);
+	if (get<0>(shape).size() == 0)
+	{
+		return "";
+	}
+	sprintf(codegen_buf, "fautoarray<%s, %d>", vinfo->type.get_what().c_str(), (int)get<0>(shape).size());
+	return string(codegen_buf);
+}
+
+std::string gen_static_dims_str(FunctionInfo * finfo, ParseNode & slice_node, long long & flatsize) {
+	// the dimensions `, fstaticdim<1, 10>, ...` of an array whose bounds are all literals, or ""
+	for (ParseNode * slice : slice_node)
+	{
+		if (slice->token_equals(TokenMeta::NT_SLICE) && (slice->length() != 2 || slice->get(0).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY)))
+		{
+			return "";
+		}
+	}
+	SliceBoundInfo shape = get_lbound_size_from_slice(finfo, slice_node);
+	const std::vector<std::string> & lbound_vec = get<0>(shape);
+	const std::vector<std::string> & size_vec = get<1>(shape);
+	flatsize = 1;
+	string dims;
+	for (size_t i = 0; i < lbound_vec.size(); i++)
+	{
+		string lb = int_literal_str(lbound_vec[i]), sz = int_literal_str(size_vec[i]);
+		if (lb == "" || sz == "")
+		{
+			return "";
+		}
+		flatsize *= std::atoll(sz.c_str());
+		if (flatsize <= 0 || flatsize > INT_MAX)
+		{
+			return "";
+		}
+		sprintf(codegen_buf, ", fstaticdim<%s, %s>", lb.c_str(), sz.c_str());
+		dims += string(codegen_buf);
+	}
+	return dims;
+}
+
 std::string regen_vardef_array_initial_str(FunctionInfo * finfo, VariableInfo * vinfo, ParseNode & slice_node) {
 	ParseNode & entity_variable = vinfo->entity_variable;
 	string alias_name = get_variable_name(entity_variable);
@@ -151,15 +271,62 @@ std::string regen_vardef_array_initial_str(FunctionInfo * finfo, VariableInfo *
 		sprintf(codegen_buf, "{%s};\n", gen_sliceinfo_str(lbound_vec.begin(), lbound_vec.end(), size_vec.begin(), size_vec.end()).c_str());
 		arr_decl += string(codegen_buf);
 		ParseNode & arraybuilder = entity_variable.get(1); // initial value is array_builder rule
-		regen_arraybuilder(finfo, arraybuilder);
-		sprintf(codegen_buf, "%s = %s", alias_name.c_str(), arraybuilder.get_what().c_str());
-		arr_decl += string(codegen_buf);
+		std::string fill = gen_arraybuilder_fill(finfo, vinfo, alias_name, arraybuilder), init_str;
+		if (fill != "")
+		{
+			// filled in place
+			init_str = fill;
+		}
+		else {
+			regen_arraybuilder(finfo, arraybuilder);
+			sprintf(codegen_buf, "%s = %s", alias_name.c_str(), arraybuilder.get_what().c_str());
+			fill = string(codegen_buf);
+			init_str = fill + ";";
+		}
+		if (vinfo->desc.save.get() || finfo->global_scope)
+		{
+			// saved, or at namespace scope where no statement can be
+			arr_decl += gen_init_once(finfo, alias_name + "_initialized", init_str);
+		}
+		else {
+			arr_decl += fill;
+		}
 	}
 	entity_variable.setattr(new VariableAttr(vinfo));
 	return arr_decl;
 }
 
 
+std::string gen_init_once(FunctionInfo * finfo, const std::string & name, const std::string & init_str) {
+	/*****************
+	* `init_str` runs once, when the static variable `name` is initialized
+	*	, so a saved variable is not initialized again in every call
+	* at namespace scope, e.g. in a module, the lambda can't capture
+	*****************/
+	return "static const bool " + name + " = [" + (finfo->global_scope ? "" : "&") + "]() {\n" + tabber(init_str) + "\treturn true;\n}()";
+}
+
+void regen_data(FunctionInfo * finfo, ParseNode & data_stmt) {
+	/*****************
+	* variables initialized by `data` are saved, and are initialized once, ref `gen_init_once`
+	*	`data a, b(2) / 1, 2 /` is `a = 1; b(2) = 2;`
+	*****************/
+	ParseNode & suite = data_stmt.get(0);
+	for (ParseNode * stmt : suite)
+	{
+		const ParseNode & target = stmt->get(0).get(0);
+		string name = target.token_equals(TokenMeta::NT_FUCNTIONARRAY) ? target.get(0).get_what() : target.get_what();
+		VariableInfo * vinfo = check_implicit_variable(finfo, name);
+		if (vinfo->commonblock_name == "" && !vinfo->declared)
+		{
+			vinfo->desc.save = true;
+		}
+	}
+	regen_suite(finfo, suite, true);
+	sprintf(codegen_buf, "data_%d", get_source_line(data_stmt));
+	data_stmt.get_what() = gen_init_once(finfo, string(codegen_buf), suite.get_what()) + ";";
+}
+
 std::string get_variable_name(const ParseNode & entity_variable) {
 	if (entity_variable.token_equals(TokenMeta::NT_VARIABLE_ENTITY))
 	{
@@ -290,6 +457,15 @@ std::string regen_vardef(FunctionInfo * finfo, VariableInfo * vinfo, std::string
     string pointer_name_reserve = is_target?vinfo->vardef_node->get_what():"";
 	bool do_arr = (!is_pointer)&&(vinfo->is_array() || is_function_array(entity_variable));
 	string var_decl, type_str;
+	if (save_to_node && !is_pointer && !is_target && finfo != nullptr && !finfo->global_scope && finfo != get_function("", "program")
+		&& entity_variable.length() > 1 && !entity_variable.get(1).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY)
+		&& !desc.constant.get() && !desc.reference.get() && !desc.inout_reference.get() && !desc.optional.get()
+		&& !vinfo->declared && vinfo->commonblock_name == "" && !type_nospec.token_equals(TokenMeta::Function)
+		&& std::find(finfo->funcdesc.paramtable_info.begin(), finfo->funcdesc.paramtable_info.end(), vinfo->local_name) == finfo->funcdesc.paramtable_info.end())
+	{
+		// a local variable initialized in its declaration is saved, so it is initialized once
+		desc.save = true;
+	}
 	/*****************
 	* IMPORTANT
 	* this function should handle `Function_Decl`(function variables which are often declared by `interface`)
@@ -322,6 +498,20 @@ std::string regen_vardef(FunctionInfo * finfo, VariableInfo * vinfo, std::string
 		// get slice info
 		type_str = gen_qualified_typestr(type_nospec, desc, false);
 		string initial = is_target? "{}":regen_vardef_array_initial_str(finfo, vinfo, desc.slice.get());
+		string static_type_str = (is_target || !save_to_node) ? "" : gen_static_array_typestr(finfo, vinfo, desc.slice.get());
+		string auto_type_str = (is_target || !save_to_node || static_type_str != "") ? "" : gen_auto_array_typestr(finfo, vinfo, desc.slice.get());
+		string farray_str = "farray<" + type_nospec.get_what() + ">";
+		if (static_type_str != "")
+		{
+			// the shape is in the type, so only the initial value is kept
+			type_str.replace(type_str.find(farray_str), farray_str.size(), static_type_str);
+			size_t initial_value = initial.find(";\n");
+			initial = "{}" + (initial_value == string::npos ? "" : initial.substr(initial_value));
+		}
+		else if (auto_type_str != "") {
+			// the shape is given to the constructor, as to `farray`
+			type_str.replace(type_str.find(farray_str), farray_str.size(), auto_type_str);
+		}
 		sprintf(codegen_buf, "%s %s %s", type_str.c_str(), alias_name.c_str(), initial.c_str());
 		var_decl = string(codegen_buf);
 
@@ -354,6 +544,13 @@ std::string regen_vardef(FunctionInfo * finfo, VariableInfo * vinfo, std::string
 	else {
 		// SCALAR
 		type_str = gen_qualified_typestr(type_nospec, desc, false);
+		ConstValue value;
+		if (!is_pointer && desc.constant.get() && save_to_node && type_str.compare(0, 6, "const ") == 0 && (is_int(type_nospec) || is_floating(type_nospec))
+			&& !entity_variable.get(1).token_equals(TokenMeta::NT_VARIABLEINITIALDUMMY) && eval_const_exp(finfo, entity_variable.get(1), value))
+		{
+			// a named constant whose value is folded
+			type_str = "constexpr " + type_str.substr(6);
+		}
 		sprintf(codegen_buf, "%s %s", type_str.c_str(), alias_name.c_str());
 		var_decl = string(codegen_buf);
 		var_decl += (is_pointer)?" = nullptr": regen_vardef_scalar_initial_str(finfo, vinfo);
@@ -19,6 +19,7 @@
 
 #include "gen_common.h"
 #include <map>
+#include <set>
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm.hpp>
 #include <boost/range/irange.hpp>
@@ -29,6 +30,40 @@
 //based on storage association(14.6.3).The common blocks specified by the COMMON statement may be named
 //and are called named common blocks, or may be unnamed and are called blank common.
 
+namespace {
+	// element types of a common block which is laid out as one storage, ref `gen_common_definition`
+	const std::set<std::string> common_storage_types{ "int", "int8_t", "int16_t", "int32_t", "int64_t", "float", "double", "long double", "bool" };
+
+	std::vector<VariableInfo *> * get_common_layout(CommonBlockInfo * common_info, FunctionInfo * finfo) {
+		for (std::pair<FunctionInfo *, std::vector<VariableInfo *>> & layout : common_info->layouts)
+		{
+			if (layout.first == finfo)
+			{
+				return &layout.second;
+			}
+		}
+		return nullptr;
+	}
+
+	bool gen_common_member(FunctionInfo * finfo, VariableInfo * vinfo, std::string & dims, long long & flatsize) {
+		// the `fstaticdim`s of a member which can be stored in the storage of its common block
+		VariableDesc & desc = vinfo->desc;
+		if (common_storage_types.count(vinfo->type.get_what()) == 0 || desc.allocatable.get() || desc.pointer.get()
+			|| desc.cray_pointer.get() || desc.target.get())
+		{
+			return false;
+		}
+		dims = "";
+		flatsize = 1;
+		if (vinfo->is_array())
+		{
+			dims = get_context().parse_config.usefarray ? gen_static_dims_str(finfo, desc.slice.get(), flatsize) : "";
+			return dims != "";
+		}
+		return true;
+	}
+}
+
 CommonBlockInfo * get_commonblock(std::string commonblock_name) {
 	if (get_context().commonblocks.find(commonblock_name) != get_context().commonblocks.end()) {
 		// already exists
@@ -101,6 +136,16 @@ void regen_common(FunctionInfo * finfo, ParseNode & common_block) {
 			local_vinfo->commonblock_index = i;
 			local_vinfo->commonblock_name = commonblock_name;
 		}
+		std::vector<VariableInfo *> * layout = get_common_layout(common_info, finfo);
+		if (layout == nullptr)
+		{
+			common_info->layouts.push_back(std::make_pair(finfo, std::vector<VariableInfo *>{}));
+			layout = &common_info->layouts.back().second;
+		}
+		if (std::find(layout->begin(), layout->end(), local_vinfo) == layout->end())
+		{
+			layout->push_back(local_vinfo);
+		}
 		if (new_common)
 		{
 			// this is VariableInfo in commonblock
@@ -123,7 +168,37 @@ void regen_common(FunctionInfo * finfo, ParseNode & common_block) {
 }
 
 ParseNode gen_common_definition(std::string commonblock_name) {
+	/******************
+	* a common block whose members are numbers, logicals and arrays of them of constant bounds,
+	*	is one storage, which is a `union` of its layouts in every subprogram which declares it
+	*	, so subprograms can name, type and shape the same storage differently, like `b(3, 4)` and `d(12)`
+	*	a subprogram accesses the members of its layout, ref `gen_common_view`
+	* any other common block is a struct of the members declared by the first subprogram
+	******************/
 	CommonBlockInfo * common_info = get_commonblock(commonblock_name);
+	common_info->storage_associated = !common_info->layouts.empty();
+	string union_str;
+	for (std::pair<FunctionInfo *, std::vector<VariableInfo *>> & layout : common_info->layouts)
+	{
+		int i = 0;
+		string struct_str = make_str_list(layout.second.begin(), layout.second.end(), [&](VariableInfo * vinfo) {
+			string dims;
+			long long flatsize;
+			if (!gen_common_member(layout.first, vinfo, dims, flatsize))
+			{
+				common_info->storage_associated = false;
+			}
+			sprintf(codegen_buf, dims == "" ? "%s _%d;" : "%s _%d[%lld];", vinfo->type.get_what().c_str(), ++i, flatsize);
+			return string(codegen_buf);
+		}, "\n");
+		sprintf(codegen_buf, "struct{\n%s}%s;\n", tabber(struct_str).c_str(), layout.first->local_name.c_str());
+		union_str += string(codegen_buf);
+	}
+	if (common_info->storage_associated)
+	{
+		sprintf(codegen_buf, "union{\n%s}BLOCK_%s;\n", tabber(union_str).c_str(), commonblock_name.c_str());
+		return gen_token(Term{ TokenMeta::NT_COMMONBLOCKDEFINE, string(codegen_buf) });
+	}
 	std::vector<VariableInfo *> & common_variables = common_info->variables;
 	int i = 0;
 	string struct_str = make_str_list(common_variables.begin(), common_variables.end(), [&](VariableInfo * vinfo) {
@@ -141,6 +216,38 @@ ParseNode gen_common_definition(std::string commonblock_name) {
 	return gen_token(Term{ TokenMeta::NT_COMMONBLOCKDEFINE, string(codegen_buf) });
 }
 
+std::string gen_common_view(FunctionInfo * finfo, VariableInfo * vinfo) {
+	/******************
+	* the declaration of a member of a common block in its layout, ref `gen_common_definition`
+	*	a scalar is a reference, and an array is a `fstaticview` of its elements
+	*	, so subprograms share the storage without copying
+	* returns "" if the common block is a struct
+	******************/
+	CommonBlockInfo * common_info = get_commonblock(vinfo->commonblock_name);
+	std::vector<VariableInfo *> * layout = common_info == nullptr || !common_info->storage_associated ? nullptr : get_common_layout(common_info, finfo);
+	if (layout == nullptr)
+	{
+		return "";
+	}
+	std::vector<VariableInfo *>::iterator it = std::find(layout->begin(), layout->end(), vinfo);
+	string dims;
+	long long flatsize;
+	if (it == layout->end() || !gen_common_member(finfo, vinfo, dims, flatsize))
+	{
+		return "";
+	}
+	sprintf(codegen_buf, "BLOCK_%s.%s._%d", vinfo->commonblock_name.c_str(), finfo->local_name.c_str(), (int)(it - layout->begin()) + 1);
+	string member = string(codegen_buf);
+	if (dims == "")
+	{
+		sprintf(codegen_buf, "%s & %s = %s;\n", vinfo->type.get_what().c_str(), vinfo->local_name.c_str(), member.c_str());
+	}
+	else {
+		sprintf(codegen_buf, "fstaticview<%s%s> %s{ %s };\n", vinfo->type.get_what().c_str(), dims.c_str(), vinfo->local_name.c_str(), member.c_str());
+	}
+	return string(codegen_buf);
+}
+
 
 VariableInfo * check_implicit_variable(FunctionInfo * finfo, const std::string & name) {
 	/******************